@@ -2,34 +2,241 @@
 #define ADRESSABLE_LED_STRIP_H
 
 #include <LED_Strip.h>
+#include <LED_Effects.h>
 
 class Adressable_LED_Strip : public LED_Strip
 {
 protected:
-  uint8_t m_LastHue = 0;
-  int m_PointPosition = 0;
-  bool m_PointDirection = true;
+  Sparkle_Effect m_sparkle; // state of built in effects
+  SectionColor_Effect m_section_color;
+  SpectrumHue_Effect m_spectrum_hue;
+  MovingPoint_Effect m_moving_point;
+  MovingHue_Effect m_moving_hue;
 
 public:
   Adressable_LED_Strip() : LED_Strip(1) {}
   Adressable_LED_Strip(const int p_nleds) : LED_Strip(p_nleds) {}
+  Adressable_LED_Strip(CRGB *leds, const int p_nleds) : LED_Strip(leds, p_nleds) {}
 
   Adressable_LED_Strip &setSingleColor(const CRGB &color, const int i)
   {
-    m_last_update = millis();
+    if (i >= m_num_leds || i < 0)
+      return *this;        //abort if out of index
+    setMode(MODE::MANY); //set mode to many to allow individual adressing of leds
+    CRGB &raw = rawLeds()[rawIndex(i)];
+    if (raw != color)
+    {
+      powerSum(i, i, false);
+      raw = color;  //assign correct
+      powerSum(i, i, true);
+      markDirty(i); //only changed leds have to be recalculated
+    }
+    return *this;
+  }
+
+  /**
+   * modify count leds starting at first in place
+   * @param edit function object called with (CRGB *leds, uint16_t first, uint16_t count) for each contiguous part of the raw buffer
+  */
+  template <class EDIT>
+  Adressable_LED_Strip &editRaw(const uint16_t first, uint16_t count, EDIT edit)
+  {
+    if (first >= m_num_leds || count == 0)
+      return *this;
+    count = min(count, (uint16_t)(m_num_leds - first));
+
+    setMode(MODE::MANY);
+    CRGB *raw = rawLeds();
+    powerSum(first, first + count - 1, false);
+
+    // ring buffer -> at most two contiguous parts
+    uint16_t p = rawIndex(first);
+    uint16_t part = min(count, (uint16_t)(m_num_leds - p));
+    edit(&raw[p], first, part);
+    if (part < count)
+      edit(raw, first + part, count - part);
+
+    powerSum(first, first + count - 1, true);
+    markDirty(first, first + count - 1);
+    return *this;
+  }
+
+  /**
+   * set count leds starting at first to one color
+  */
+  Adressable_LED_Strip &setRangeColor(const CRGB &color, const uint16_t first, const uint16_t count)
+  {
+    return editRaw(first, count, [&color](CRGB *leds, const uint16_t, const uint16_t n) { bulkFill(leds, n, color); });
+  }
+
+  /**
+   * fill count leds starting at offset directly from a byte source, 3 bytes per led in r g b order
+   * @param source object with size_t read(uint8_t *dst, size_t bytes) returning the number of bytes written
+   * @returns number of leds written
+  */
+  template <class SOURCE>
+  uint16_t readRaw(const uint16_t offset, uint16_t count, SOURCE &source)
+  {
+    if (offset >= m_num_leds)
+      return 0;
+    count = min(count, (uint16_t)(m_num_leds - offset));
+    if (count == 0)
+      return 0;
+
+    setMode(MODE::MANY);
+    CRGB *raw = rawLeds();
+    powerSum(offset, offset + count - 1, false);
+
+    // ring buffer -> at most two contiguous parts
+    uint16_t p = rawIndex(offset);
+    uint16_t first = min(count, (uint16_t)(m_num_leds - p));
+    size_t bytes = source.read((uint8_t *)&raw[p], first * 3);
+    if (first < count && bytes == first * 3u)
+      bytes += source.read((uint8_t *)raw, (count - first) * 3);
+
+    powerSum(offset, offset + count - 1, true);
+    uint16_t written = bytes / 3;
+    if (written > 0)
+      markDirty(offset, offset + written - 1);
+    return written;
+  }
+
+  /**
+   * copy count leds from rgb byte array starting at led offset
+   * @returns number of leds written
+  */
+  uint16_t writeRaw(const uint16_t offset, const uint8_t *rgb, const uint16_t count)
+  {
+    struct
+    {
+      const uint8_t *p;
+      size_t read(uint8_t *dst, size_t n)
+      {
+        memcpy(dst, p, n);
+        p += n;
+        return n;
+      }
+    } source = {rgb};
+    return readRaw(offset, count, source);
+  }
+
+  /**
+   * set palette and switch to palette mode, leds store one index into the palette instead of a color
+   * @param size number of colors, the palette holds 16 entries if size <= 16 else 256
+  */
+  Adressable_LED_Strip &setPalette(const CRGB *colors, const uint16_t size)
+  {
+    allocPalette(size <= 16 ? 16 : 256);
+    for (uint16_t k = 0; k < m_palette_size; k++)
+    {
+      m_palette[k] = k < size ? colors[k] : CRGB(0);
+    }
+    m_palette_changed = true;
+    setMode(MODE::PALETTE);
+    markAllDirty();
+    return *this;
+  }
 
-    if (i > m_num_leds || i < 0)
-      return *this;          //abort if out of index
-    m_led_mode = MODE::MANY; //set mode to many to allow individual adressing of leds
-    m_leds_raw[i] = color;   //assign correct
+  Adressable_LED_Strip &setPaletteColor(const uint8_t k, const CRGB &color)
+  {
+    if (!m_palette)
+      allocPalette(16);
+    CRGB &entry = m_palette[k & (m_palette_size - 1)];
+    if (entry != color)
+    {
+      entry = color;
+      m_palette_changed = true;
+      markAllDirty();
+    }
     return *this;
   }
 
+  inline CRGB getPaletteColor(const uint8_t k)
+  {
+    return m_palette ? m_palette[k & (m_palette_size - 1)] : CRGB(0);
+  }
+
+  inline uint16_t getPaletteSize()
+  {
+    return m_palette_size;
+  }
+
+  /**
+   * move all palette colors by n entries towards higher entries
+   * color cycling costs one pass over the palette instead of one over all leds
+  */
+  Adressable_LED_Strip &rotatePalette(const int16_t n)
+  {
+    if (!m_palette)
+      return *this;
+
+    uint16_t shift = ((n % (int16_t)m_palette_size) + m_palette_size) % m_palette_size;
+    if (shift == 0)
+      return *this;
+    // rotation by three reversals, no temporary palette
+    auto reverse = [this](uint16_t first, uint16_t end) {
+      for (; first + 1 < end; first++, end--)
+      {
+        CRGB t = m_palette[first];
+        m_palette[first] = m_palette[end - 1];
+        m_palette[end - 1] = t;
+      }
+    };
+    reverse(0, m_palette_size);
+    reverse(0, shift);
+    reverse(shift, m_palette_size);
+
+    m_palette_changed = true;
+    markAllDirty();
+    return *this;
+  }
+
+  /**
+   * set led i to palette entry k and switch to palette mode
+  */
+  Adressable_LED_Strip &setPaletteIndex(const uint8_t k, const int i)
+  {
+    if (i >= m_num_leds || i < 0)
+      return *this;
+    setMode(MODE::PALETTE);
+    uint8_t &index = m_indices[rawIndex(i)];
+    uint8_t next = k & (m_palette_size - 1);
+    if (index != next)
+    {
+      m_palette_count[index]--;
+      m_palette_count[next]++;
+      index = next;
+      markDirty(i);
+    }
+    return *this;
+  }
+
+  inline uint8_t getPaletteIndex(const int i)
+  {
+    if (!m_indices || i < 0 || i >= m_num_leds)
+      return 0;
+    return m_indices[rawIndex(i)];
+  }
+
+  /**
+   * @returns color set for led i before brightness, color correction and reverse are applied
+  */
+  CRGB getRawColor(const int i)
+  {
+    if (i < 0 || i >= m_num_leds)
+      return CRGB(0);
+    if (m_led_mode == MODE::PALETTE)
+      return m_palette[m_indices[rawIndex(i)]];
+    if (m_led_mode == MODE::MANY && m_leds_raw)
+      return m_leds_raw[rawIndex(i)];
+    return m_single_color;
+  }
+
   CRGB &getSingleColor(const int i)
   {
     if (i < 0 || i >= m_num_leds)
-      return m_leds[0]; //return first element if out of index
-    return m_leds[i];   //return reference to element at index
+      return m_leds[0];                                //return first element if out of index
+    return m_leds[m_reverse ? m_num_leds - 1 - i : i]; //return reference to element at index
   }
 
   inline CRGB &operator[](const int i)
@@ -37,17 +244,11 @@ public:
     return getSingleColor(i);
   }
 
+  // effects stepping once per call, use LED_Effect_Engine for time based effects
+
   Adressable_LED_Strip &sparkle()
   {
-    setMode(MANY);
-
-    int id = 0;
-    fadeall(220);
-    for (int i = 0; i < 1; i++)
-    {
-      id = map(random8(), 0, 255, 0, m_num_leds - 1);
-      setSingleColor(CRGB(255, 255, random8()), id);
-    }
+    m_sparkle.step(*this);
     return *this;
   }
 
@@ -56,68 +257,25 @@ public:
     if (sec_size <= 0)
       return *this;
 
-    setMode(MANY);
-
-    for (int i = 0; i < m_num_leds; i++)
-    {
-      switch ((i / sec_size) % 3)
-      {
-      case 0:
-        setSingleColor(CRGB::Red, i);
-        break;
-      case 1:
-        setSingleColor(CRGB::Green, i);
-        break;
-      case 2:
-        setSingleColor(CRGB::Blue, i);
-        break;
-      }
-    }
+    m_section_color.setSectionSize(sec_size).step(*this);
     return *this;
   }
 
   Adressable_LED_Strip &spectrumHue()
   {
-    setMode(MANY);
-
-    for (int i = m_num_leds - 1; i >= 1; i--)
-    {
-      m_leds_raw[i] = m_leds_raw[i - 1];
-    }
-    setSingleColor(CHSV(m_LastHue++, 255, 255), 0);
+    m_spectrum_hue.step(*this);
     return *this;
   }
 
   Adressable_LED_Strip &movingPoint(const CRGB &c)
   {
-    setMode(MANY);
-
-    setSingleColor(c, m_PointPosition);
-    fadeall(250);
-    if (m_PointDirection)
-    {
-      m_PointPosition++;
-      if (m_PointPosition == m_num_leds)
-      {
-        m_PointDirection = false;
-        m_PointPosition = m_num_leds - 1;
-      }
-    }
-    else
-    {
-      m_PointPosition--;
-      if (m_PointPosition == -1)
-      {
-        m_PointDirection = true;
-        m_PointPosition = 0;
-      }
-    }
+    m_moving_point.setColor(c).step(*this);
     return *this;
   }
 
   virtual Adressable_LED_Strip &movingHue()
   {
-    movingPoint(CHSV(m_LastHue++, 255, 255));
+    m_moving_hue.step(*this);
     return *this;
   }
 };
@@ -0,0 +1,607 @@
+#ifndef CRGB_Q_H
+#define CRGB_Q_H
+
+#include <FastLED.h>
+#include <Printable.h>
+
+/**
+ * fixed point version of CRGB_d
+ * each channel is stored as unsigned Q8.8 (value * 256) in the range 0.0 - 255.0
+ * all arithmetic is integer only, double arguments are converted once per call
+ * channels read and write the Q8.8 value, c.r = 200 << 8 sets 200.0 and c.r.toDouble() reads it as double,
+ * use toCRGB() for the rounded 8 bit color
+*/
+class CRGB_q : public Printable
+{
+public:
+  static const int32_t MAX_Q = 255 << 8; // 255.0 in Q8.8
+
+  /**
+   * one channel, reads and writes the Q8.8 value (200 << 8 == 200.0) saturating at 255.0,
+   * use toDouble() and setDouble() to convert explicitly
+  */
+  struct Channel
+  {
+    uint16_t q; // value in Q8.8
+
+    inline operator uint16_t() const
+    {
+      return q;
+    }
+
+    inline Channel& operator= (int32_t v)
+    {
+      q = clampQ(v);
+      return *this;
+    }
+
+    inline Channel& operator+= (int32_t v)
+    {
+      q = clampQ((int32_t)q + v);
+      return *this;
+    }
+
+    inline Channel& operator-= (int32_t v)
+    {
+      q = clampQ((int32_t)q - v);
+      return *this;
+    }
+
+    /// channel value in the range 0.0 - 255.0
+    inline double toDouble() const
+    {
+      return q / 256.0;
+    }
+
+    /// set the channel from a value in the range 0.0 - 255.0, saturating
+    inline Channel& setDouble(double v)
+    {
+      q = toQ(v);
+      return *this;
+    }
+  };
+
+  union {
+    struct {
+      union {
+        Channel r;
+        Channel red;
+      };
+      union {
+        Channel g;
+        Channel green;
+      };
+      union {
+        Channel b;
+        Channel blue;
+      };
+    };
+    Channel raw[3];
+  };
+
+  size_t printTo(Print& p) const{//allow printing to Serial
+    size_t s = 0;
+    s += p.print("r:");
+    s += p.print(r.toDouble());
+    s += p.print(" g:");
+    s += p.print(g.toDouble());
+    s += p.print(" b:");
+    s += p.print(b.toDouble());
+    return s;
+  }
+
+  /// Array access operator to index into the channels as Q8.8
+  inline Channel& operator[] (uint8_t x) __attribute__((always_inline))
+  {
+    return raw[x];
+  }
+
+  /// Array access operator to index into the channels as Q8.8
+  inline const Channel& operator[] (uint8_t x) const __attribute__((always_inline))
+  {
+    return raw[x];
+  }
+
+  ///default constructor -> init with zero
+  inline CRGB_q() __attribute__((always_inline))
+    : r{0}, g{0}, b{0}
+  {
+  }
+
+  /// allow construction from R, G, B
+  inline CRGB_q( double ir, double ig, double ib)  __attribute__((always_inline))
+    : r{toQ(ir)}, g{toQ(ig)}, b{toQ(ib)}
+  {
+  }
+
+  /// allow construction from 32-bit (really 24-bit) bit 0xRRGGBB color code
+  inline CRGB_q( uint32_t colorcode)  __attribute__((always_inline))
+    : r{toQ8(colorcode >> 16)}, g{toQ8(colorcode >> 8)}, b{toQ8(colorcode)}
+  {
+  }
+
+  /// allow construction from a LEDColorCorrection enum
+  inline CRGB_q( LEDColorCorrection colorcode) __attribute__((always_inline))
+    : r{toQ8(colorcode >> 16)}, g{toQ8(colorcode >> 8)}, b{toQ8(colorcode)}
+  {
+
+  }
+
+  /// allow construction from a ColorTemperature enum
+  inline CRGB_q( ColorTemperature colorcode) __attribute__((always_inline))
+    : r{toQ8(colorcode >> 16)}, g{toQ8(colorcode >> 8)}, b{toQ8(colorcode)}
+  {
+
+  }
+
+  /// allow copy construction
+  inline CRGB_q(const CRGB_q& rhs) __attribute__((always_inline))
+    : r(rhs.r), g(rhs.g), b(rhs.b)
+  {
+  }
+
+  /// allow copy construction
+  inline CRGB_q(const CRGB& rhs) __attribute__((always_inline))
+    : r{toQ8(rhs.r)}, g{toQ8(rhs.g)}, b{toQ8(rhs.b)}
+  {
+  }
+
+  /// allow construction from HSV color
+  inline CRGB_q(const CHSV& rhs) __attribute__((always_inline))
+  {
+    CRGB c;
+    hsv2rgb_rainbow( rhs, c);
+    *this = c;
+  }
+
+  /// convert to 8 bit color, rounding each channel
+  inline CRGB toCRGB() const
+  {
+    return CRGB(round8(r.q), round8(g.q), round8(b.q));
+  }
+
+  /// allow assignment from one RGB struct to another
+  inline CRGB_q& operator= (const CRGB_q& rhs) __attribute__((always_inline))
+  {
+    r = rhs.r;
+    g = rhs.g;
+    b = rhs.b;
+    return *this;
+  }
+
+  /// allow assignment from one RGB struct to another
+  inline CRGB_q& operator= (const CRGB& rhs) __attribute__((always_inline))
+  {
+    r.q = toQ8(rhs.r);
+    g.q = toQ8(rhs.g);
+    b.q = toQ8(rhs.b);
+    return *this;
+  }
+
+  /// allow assignment from 32-bit (really 24-bit) 0xRRGGBB color code
+  inline CRGB_q& operator= (const uint32_t colorcode) __attribute__((always_inline))
+  {
+    return setColorCode(colorcode);
+  }
+
+  /// allow assignment from R, G, and B
+  inline CRGB_q& setRGB (double nr, double ng, double nb) __attribute__((always_inline))
+  {
+    r.q = toQ(nr);
+    g.q = toQ(ng);
+    b.q = toQ(nb);
+    return *this;
+  }
+
+  /// allow assignment from H, S, and V
+  inline CRGB_q& setHSV (uint8_t hue, uint8_t sat, uint8_t val) __attribute__((always_inline))
+  {
+    CRGB c;
+    hsv2rgb_rainbow( CHSV(hue, sat, val), c);
+    *this = c;
+    return *this;
+  }
+
+  /// allow assignment from just a Hue, saturation and value automatically at max.
+  inline CRGB_q& setHue (uint8_t hue) __attribute__((always_inline))
+  {
+    return this->setHSV (hue, 255, 255);
+  }
+
+  ///conversion from PhillipsHue XY to RGB
+  CRGB_q& setXY(float x, float y, uint8_t bri){
+    return setXYq16(x * 65536.0f, y * 65536.0f, bri);
+  }
+
+  ///conversion from PhillipsHue XY to RGB with x and y as Q16 (65536 == 1.0), integer only
+  CRGB_q& setXYq16(int32_t x, int32_t y, uint8_t bri){
+    int32_t optimal_bri = bri;
+    if (optimal_bri < 5) {
+      optimal_bri = 5;
+    }
+    int32_t Y = y >> 2;// Q14 so the matrix products fit in 32 bit
+    int32_t X = x >> 2;
+    int32_t Z = 16384 - X - Y;
+
+    // sRGB D65 conversion (Matrix) with Q14 coefficients -> Q16 result
+    int32_t r = ( X * 53094 - Y * 25185 - Z * 8169) >> 12;
+    int32_t g = (-X * 15874 + Y * 30733 + Z * 680) >> 12;
+    int32_t b = ( X * 913 - Y * 3342 + Z * 17318) >> 12;
+
+    // Apply gamma correction
+    r = gammaQ16(r);
+    g = gammaQ16(g);
+    b = gammaQ16(b);
+
+    int32_t maxv = 0;// calc the maximum value of r g and b
+    if (r > maxv) maxv = r;
+    if (g > maxv) maxv = g;
+    if (b > maxv) maxv = b;
+
+    r = r < 0 ? 0 : r;// limit to min zero
+    g = g < 0 ? 0 : g;
+    b = b < 0 ? 0 : b;
+
+    if (maxv > 0) {// only if maximum value is greater than zero, otherwise there would be division by zero
+      while (maxv > 0xFFFF) {// keep the quotient within 32 bit
+        maxv >>= 1;
+        r >>= 1;
+        g >>= 1;
+        b >>= 1;
+      }
+      r = ((uint32_t)r << 16) / maxv;// scale to maximum so the brightest light is always 1.0
+      g = ((uint32_t)g << 16) / maxv;// brightness is computed later
+      b = ((uint32_t)b << 16) / maxv;
+    }
+
+    this->r.q = clampQ((r * optimal_bri) >> 8);// scale by brightness
+    this->g.q = clampQ((g * optimal_bri) >> 8);
+    this->b.q = clampQ((b * optimal_bri) >> 8);
+    return *this;
+  }
+
+  ///conversion from PhillipsHue HSB to RGB, integer only
+  CRGB_q& setHSB(int hue, uint8_t sat, uint8_t bri){
+    int32_t v = (int32_t)bri << 8;
+
+    if (sat == 0) {
+      this->r.q = v;
+      this->g.q = v;
+      this->b.q = v;
+      return *this;
+    }
+    int32_t hh = hue;
+    if (hh >= 65535 || hh < 0) hh = 0;
+    int32_t i = hh / 11850;
+    int32_t ff = ((hh - i * 11850) << 16) / 11850;// Q16 fraction within sector
+
+    int32_t p = ((int32_t)bri * (255 - sat) * 256 + 127) / 255;
+    int32_t q = ((int32_t)bri * (65536 - (sat * ff + 127) / 255)) >> 8;
+    int32_t t = ((int32_t)bri * (65536 - (sat * (65536 - ff) + 127) / 255)) >> 8;
+
+    switch (i) {
+    case 0:
+      this->r.q = v;
+      this->g.q = t;
+      this->b.q = p;
+      break;
+    case 1:
+      this->r.q = q;
+      this->g.q = v;
+      this->b.q = p;
+      break;
+    case 2:
+      this->r.q = p;
+      this->g.q = v;
+      this->b.q = t;
+      break;
+
+    case 3:
+      this->r.q = p;
+      this->g.q = q;
+      this->b.q = v;
+      break;
+    case 4:
+      this->r.q = t;
+      this->g.q = p;
+      this->b.q = v;
+      break;
+    case 5:
+    default:
+      this->r.q = v;
+      this->g.q = p;
+      this->b.q = q;
+      break;
+    }
+    return *this;
+  }
+
+  /// allow assignment from HSV color
+  inline CRGB_q& operator= (const CHSV& rhs) __attribute__((always_inline))
+  {
+    CRGB c;
+    hsv2rgb_rainbow( rhs, c);
+    return *this = c;
+  }
+
+  /// allow assignment from 32-bit (really 24-bit) 0xRRGGBB color code
+  inline CRGB_q& setColorCode (uint32_t colorcode) __attribute__((always_inline))
+  {
+    r.q = toQ8(colorcode >> 16);
+    g.q = toQ8(colorcode >> 8);
+    b.q = toQ8(colorcode);
+    return *this;
+  }
+
+  bool operator== (const CRGB_q c) const{
+    return r.q == c.r.q && g.q == c.g.q && b.q == c.b.q;
+  }
+
+  bool operator!= (const CRGB_q c) const{
+    return r.q != c.r.q || g.q != c.g.q || b.q != c.b.q;
+  }
+
+  /// add one RGB to another, saturating at 0xFF for each channel
+  inline CRGB_q& operator+= (const CRGB_q& rhs )
+  {
+    r.q = clampQ((int32_t)r.q + rhs.r.q);
+    g.q = clampQ((int32_t)g.q + rhs.g.q);
+    b.q = clampQ((int32_t)b.q + rhs.b.q);
+    return *this;
+  }
+
+  /// add a contstant to each channel, saturating at 0xFF
+  inline CRGB_q& addToRGB (uint8_t d )
+  {
+    return offset((int32_t)d << 8);
+  }
+
+  /// subtract one RGB from another, saturating at 0x00 for each channel
+  inline CRGB_q& operator-= (const CRGB_q& rhs )
+  {
+    r.q = clampQ((int32_t)r.q - rhs.r.q);
+    g.q = clampQ((int32_t)g.q - rhs.g.q);
+    b.q = clampQ((int32_t)b.q - rhs.b.q);
+    return *this;
+  }
+
+  /// subtract a constant from each channel, saturating at 0x00
+  inline CRGB_q& subtractFromRGB(double d )
+  {
+    return offset(-(int32_t)toQ(d));
+  }
+
+  /// subtract a constant of '1' from each channel, saturating at 0x00
+  inline CRGB_q& operator-- ()  __attribute__((always_inline))
+  {
+    return offset(-256);
+  }
+
+  /// subtract a constant of '1' from each channel, saturating at 0x00
+  inline CRGB_q operator-- (int )  __attribute__((always_inline))
+  {
+    CRGB_q retval(*this);
+    --(*this);
+    return retval;
+  }
+
+  /// add a constant of '1' from each channel, saturating at 0xFF
+  inline CRGB_q& operator++ ()  __attribute__((always_inline))
+  {
+    return offset(256);
+  }
+
+  /// add a constant of '1' from each channel, saturating at 0xFF
+  inline CRGB_q operator++ (int )  __attribute__((always_inline))
+  {
+    CRGB_q retval(*this);
+    ++(*this);
+    return retval;
+  }
+
+  /// divide each of the channels by a constant
+  inline CRGB_q& operator/= (double d )
+  {
+    if (d <= 0) {// division by zero or negative -> saturate like CRGB_d
+      r.q = d < 0 || !r.q ? 0 : MAX_Q;
+      g.q = d < 0 || !g.q ? 0 : MAX_Q;
+      b.q = d < 0 || !b.q ? 0 : MAX_Q;
+      return *this;
+    }
+    return scaleQ16(factorQ16(1.0 / d));
+  }
+
+  /// multiply each of the channels by a constant,
+  /// saturating each channel at 0xFF
+  CRGB_q& operator*= (double d )
+  {
+    return scaleQ16(factorQ16(d));
+  }
+
+  CRGB_q operator*(double d) const{
+    CRGB_q c(*this);
+    return c *= d;
+  }
+
+  CRGB_q operator/(double d) const{
+    CRGB_q c(*this);
+    return c /= d;
+  }
+
+  CRGB_q operator+(uint8_t d) const{
+    CRGB_q c(*this);
+    return c.addToRGB(d);
+  }
+
+  CRGB_q operator+(CRGB_q d) const{
+    CRGB_q c(*this);
+    return c += d;
+  }
+
+  CRGB_q operator-(uint8_t d) const{
+    CRGB_q c(*this);
+    return c.offset(-((int32_t)d << 8));
+  }
+
+  CRGB_q operator-(CRGB_q d) const{
+    CRGB_q c(*this);
+    return c -= d;
+  }
+
+  /// "or" operator brings each channel up to the higher of the two values
+  inline CRGB_q& operator|= (const CRGB_q& rhs )
+  {
+    if( rhs.r.q > r.q) r.q = rhs.r.q;
+    if( rhs.g.q > g.q) g.q = rhs.g.q;
+    if( rhs.b.q > b.q) b.q = rhs.b.q;
+    return *this;
+  }
+
+  /// "or" operator brings each channel up to the higher of the two values
+  inline CRGB_q& operator|= (uint8_t d )
+  {
+    return *this |= CRGB_q(CRGB(d, d, d));
+  }
+
+  /// "and" operator brings each channel down to the lower of the two values
+  inline CRGB_q& operator&= (const CRGB_q& rhs )
+  {
+    if( rhs.r.q < r.q) r.q = rhs.r.q;
+    if( rhs.g.q < g.q) g.q = rhs.g.q;
+    if( rhs.b.q < b.q) b.q = rhs.b.q;
+    return *this;
+  }
+
+  /// "and" operator brings each channel down to the lower of the two values
+  inline CRGB_q& operator&= (uint8_t d )
+  {
+    return *this &= CRGB_q(CRGB(d, d, d));
+  }
+
+  /// this allows testing a CRGB for zero-ness
+  inline operator bool() const __attribute__((always_inline))
+  {
+    return r.q || g.q || b.q;
+  }
+
+  /// invert each channel
+  inline CRGB_q operator- () const
+  {
+    CRGB_q retval;
+    retval.r.q = MAX_Q - r.q;
+    retval.g.q = MAX_Q - g.q;
+    retval.b.q = MAX_Q - b.q;
+    return retval;
+  }
+
+  /// channels are saturated by every operation, kept for compatibility with CRGB_d
+  static CRGB_q fixOverflow8(CRGB_q& c){
+    CRGB_q r = c;//copy
+    r.fixOverflow8();
+    return r;
+  }
+
+  void fixOverflow8(){
+    if(r.q > MAX_Q) r.q = MAX_Q;
+    if(g.q > MAX_Q) g.q = MAX_Q;
+    if(b.q > MAX_Q) b.q = MAX_Q;
+  }
+
+protected:
+  /// limit a Q8.8 value to 0.0 - 255.0
+  static inline uint16_t clampQ(int32_t v)
+  {
+    return v < 0 ? 0 : (v > MAX_Q ? MAX_Q : v);
+  }
+
+  /// convert an 8 bit channel value to Q8.8
+  static inline uint16_t toQ8(uint32_t v)
+  {
+    return (v & 0xFF) << 8;
+  }
+
+  /// convert a double channel value to Q8.8, saturating
+  static inline uint16_t toQ(double v)
+  {
+    if (v <= 0) return 0;
+    if (v >= 255) return MAX_Q;
+    return v * 256.0 + 0.5;
+  }
+
+  /// round Q8.8 to nearest 8 bit integer
+  static inline uint8_t round8(uint16_t v)
+  {
+    return v >= MAX_Q ? 255 : (v + 128) >> 8;
+  }
+
+  /// convert multiplication factor to Q16.16, saturating
+  static inline uint32_t factorQ16(double d)
+  {
+    if (d <= 0) return 0;
+    if (d >= 65535.0) return 0xFFFFFFFF;
+    return d * 65536.0 + 0.5;
+  }
+
+  /// multiply each channel by a Q16.16 factor, saturating
+  inline CRGB_q& scaleQ16(uint32_t f)
+  {
+    for (uint8_t i = 0; i < 3; i++) {
+      uint64_t v = ((uint64_t)raw[i].q * f + 0x8000) >> 16;
+      raw[i].q = v > (uint64_t)MAX_Q ? MAX_Q : v;
+    }
+    return *this;
+  }
+
+  /// add a signed Q8.8 offset to each channel, saturating
+  inline CRGB_q& offset(int32_t d)
+  {
+    r.q = clampQ((int32_t)r.q + d);
+    g.q = clampQ((int32_t)g.q + d);
+    b.q = clampQ((int32_t)b.q + d);
+    return *this;
+  }
+
+  /**
+   * sRGB gamma expansion for Q16 values (65536 == 1.0)
+   * interpolated from tables with steps of 1/64 below 1.0 and 1/16 between 1.0 and 4.0
+  */
+  static int32_t gammaQ16(int32_t v)
+  {
+    static const int32_t table_lo[65] = {
+      0, 79, 159, 240, 338, 456, 595, 756,
+      940, 1148, 1381, 1639, 1923, 2234, 2572, 2939,
+      3334, 3759, 4214, 4699, 5215, 5764, 6344, 6957,
+      7603, 8283, 8997, 9746, 10530, 11350, 12206, 13098,
+      14027, 14994, 15998, 17041, 18122, 19242, 20401, 21601,
+      22840, 24120, 25441, 26803, 28206, 29652, 31140, 32670,
+      34244, 35861, 37522, 39226, 40975, 42769, 44607, 46491,
+      48421, 50396, 52418, 54486, 56601, 58764, 60973, 63231,
+      65536,
+    };
+    static const int32_t table_hi[49] = {
+      65536, 75243, 85741, 97048, 109179, 122152, 135982, 150684,
+      166275, 182768, 200178, 218519, 237804, 258047, 279262, 301460,
+      324655, 348859, 374084, 400343, 427646, 456005, 485433, 515939,
+      547535, 580233, 614041, 648972, 685035, 722241, 760600, 800122,
+      840816, 882693, 925761, 970032, 1015513, 1062215, 1110146, 1159315,
+      1209732, 1261405, 1314343, 1368555, 1424050, 1480835, 1538920, 1598313,
+      1659022,
+    };
+
+    if (v <= 2651) // linear part below 0.04045
+      return (v * 5072) >> 16;
+    if (v < 65536) {
+      int32_t k = v >> 10;
+      int32_t frac = v & 0x3FF;
+      return table_lo[k] + (((table_lo[k + 1] - table_lo[k]) * frac) >> 10);
+    }
+    if (v >= (4 << 16))
+      return table_hi[48];
+    v -= 65536;
+    int32_t k = v >> 12;
+    int32_t frac = v & 0xFFF;
+    return table_hi[k] + (((table_hi[k + 1] - table_hi[k]) * frac) >> 12);
+  }
+};
+
+#endif //CRGB_Q_H
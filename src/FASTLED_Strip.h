@@ -17,15 +17,22 @@ public:
     FastLED.setDither(0);
   }
 
-  virtual void update() override
-  { //update and show leds from this controller
-    LED_Strip::updateLeds();
+  // show leds from this controller
+  // update() only calls this if the output changed to prevent unnecessary writes using fastled and stop crashing
+  virtual void show() override
+  {
+    chipset->showLeds();
+  }
+
+  virtual bool isOutputBlocking() override
+  {
+    return FASTLED_ALLOW_INTERRUPTS == 0;
+  }
 
-    // find out if an update is necessary to prevent unnecessary writes using fastled and stop crashing
-    if (isUpdateNecessary())
-    {
-      chipset->showLeds();
-    }
+  // 24 bit per led at 800kHz plus reset time, matches the common clockless chipsets
+  virtual uint32_t getOutputTime() override
+  {
+    return m_num_leds * 30UL + 50;
   }
 };
 
@@ -0,0 +1,482 @@
+#ifndef LED_ANIMATION_H
+#define LED_ANIMATION_H
+
+#include <Adressable_LED_Strip.h>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * pre-rendered animations
+ * file format, numbers are little endian:
+ * - header: 'L' 'A' version flags fps(2) num_leds(2)
+ * - frames, each starting with its type:
+ *   - LED_ANIMATION_KEYFRAME: all leds run length coded (led_rle.h)
+ *   - LED_ANIMATION_DELTA: number of runs(2), per run: first led(2) count(2) run length coded leds,
+ *     leds outside of the runs keep the color of the previous frame
+ * - the file ends after the last frame
+ *
+ * sources provide size_t read(uint8_t *dst, size_t bytes) and bool rewind()
+*/
+
+static const uint8_t LED_ANIMATION_VERSION = 1;
+static const uint8_t LED_ANIMATION_HEADER = 8;
+static const uint8_t LED_ANIMATION_KEYFRAME = 1;
+static const uint8_t LED_ANIMATION_DELTA = 2;
+
+/**
+ * animation stored in memory, e.g. a constant array or a memory mapped file
+*/
+class LED_Memory_Source
+{
+protected:
+  const uint8_t *m_data;
+  size_t m_size;
+  size_t m_pos = 0;
+
+public:
+  LED_Memory_Source(const uint8_t *data = nullptr, const size_t size = 0) : m_data(data), m_size(size) {}
+
+  size_t read(uint8_t *dst, size_t n)
+  {
+    n = min(n, m_size - m_pos);
+    memcpy(dst, m_data + m_pos, n);
+    m_pos += n;
+    return n;
+  }
+
+  inline bool rewind()
+  {
+    m_pos = 0;
+    return true;
+  }
+};
+
+/**
+ * animation read from a file in fixed size chunks, only one chunk is held in ram
+ * FILE provides size_t read(uint8_t *buf, size_t size) and bool seek(uint32_t pos) like File of the Arduino FS
+*/
+template <class FILE, uint16_t CHUNK = 64>
+class LED_Chunked_Source
+{
+protected:
+  FILE &m_file;
+  uint8_t m_chunk[CHUNK];
+  uint16_t m_pos = 0;
+  uint16_t m_len = 0;
+
+public:
+  LED_Chunked_Source(FILE &file) : m_file(file) {}
+
+  size_t read(uint8_t *dst, size_t n)
+  {
+    size_t done = 0;
+    while (done < n)
+    {
+      if (m_pos == m_len)
+      {
+        if (n - done >= CHUNK)
+        { // large blocks bypass the chunk buffer
+          size_t r = m_file.read(dst + done, n - done);
+          return done + r;
+        }
+        m_len = m_file.read(m_chunk, CHUNK);
+        m_pos = 0;
+        if (m_len == 0)
+          break;
+      }
+      size_t part = min(n - done, (size_t)(m_len - m_pos));
+      memcpy(dst + done, m_chunk + m_pos, part);
+      m_pos += part;
+      done += part;
+    }
+    return done;
+  }
+
+  bool rewind()
+  {
+    m_pos = m_len = 0;
+    return m_file.seek(0);
+  }
+};
+
+#if defined(__linux__)
+/**
+ * animation file mapped into memory on linux hosts
+*/
+class LED_Mapped_File : public LED_Memory_Source
+{
+public:
+  LED_Mapped_File(const char *path)
+  {
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+      if (fd >= 0)
+        close(fd);
+      return;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+      return;
+    m_data = (const uint8_t *)p;
+    m_size = st.st_size;
+  }
+
+  ~LED_Mapped_File()
+  {
+    if (m_data)
+      munmap((void *)m_data, m_size);
+  }
+
+  inline bool isOpen()
+  {
+    return m_data;
+  }
+};
+#endif
+
+/**
+ * plays an animation file at its frame rate, frames are decoded directly into the raw buffer of the strip
+ * every frame has to be decoded because delta frames depend on their predecessor, if rendering falls behind
+ * up to MAX_CATCH_UP frames are decoded per render and the animation slows down beyond that
+*/
+template <class SOURCE>
+class LED_Animation_Player
+{
+public:
+  static const uint8_t MAX_CATCH_UP = 4;
+
+protected:
+  SOURCE &m_source;
+  uint16_t m_fps = 0;
+  uint16_t m_num_leds = 0;
+  uint32_t m_frame = 0; // frames decoded since start
+  bool m_loop = true;
+  bool m_valid = false;
+  bool m_finished = false;
+
+  uint32_t m_frame_time = 0; // in us
+  uint32_t m_elapsed = 0;    // in us
+  uint32_t m_last_render = 0;
+  bool m_started = false;
+
+  // decode count run length coded leds starting at first
+  bool decodeLeds(Adressable_LED_Strip &strip, const uint16_t first, const uint16_t count)
+  {
+    return ledRleDecodeBlocks(
+        m_source, count,
+        [&](const uint16_t i, const uint8_t n, const CRGB &color) {
+          strip.setRangeColor(color, first + i, n);
+        },
+        [&](const uint16_t i, const uint8_t n, SOURCE &src) -> uint8_t {
+          return strip.readRaw(first + i, n, src);
+        });
+  }
+
+  // jump to first frame
+  bool restart()
+  {
+    uint8_t h[LED_ANIMATION_HEADER];
+    m_valid = m_source.rewind() && m_source.read(h, sizeof(h)) == sizeof(h) && h[0] == 'L' && h[1] == 'A' && h[2] == LED_ANIMATION_VERSION;
+    if (m_valid)
+    {
+      m_fps = h[4] | h[5] << 8;
+      m_num_leds = h[6] | h[7] << 8;
+      m_frame_time = 1000000UL / max((uint16_t)1, m_fps);
+    }
+    return m_valid;
+  }
+
+public:
+  LED_Animation_Player(SOURCE &source) : m_source(source) {}
+
+  /**
+   * read header and start playback with the first frame
+   * @returns false if the source is not a valid animation
+  */
+  bool begin()
+  {
+    m_frame = 0;
+    m_elapsed = 0;
+    m_started = false;
+    m_finished = !restart();
+    return !m_finished;
+  }
+
+  // restart at the first frame after the last one, true by default
+  inline LED_Animation_Player &setLoop(const bool loop)
+  {
+    m_loop = loop;
+    return *this;
+  }
+
+  /**
+   * decode next frame into strip regardless of time
+   * the strip needs at least as many leds as the animation
+   * @returns false if the animation has ended or is invalid
+  */
+  bool step(Adressable_LED_Strip &strip)
+  {
+    if (m_finished || !m_valid || strip.getNumLeds() < m_num_leds)
+      return false;
+
+    uint8_t type;
+    if (m_source.read(&type, 1) != 1)
+    { // end of file
+      if (!m_loop || m_frame == 0 || !restart())
+      {
+        m_finished = true;
+        return false;
+      }
+      if (m_source.read(&type, 1) != 1)
+        return false;
+    }
+
+    bool ok = false;
+    if (type == LED_ANIMATION_KEYFRAME)
+    {
+      ok = decodeLeds(strip, 0, m_num_leds);
+    }
+    else if (type == LED_ANIMATION_DELTA)
+    {
+      uint8_t n[2] = {0, 0};
+      ok = m_source.read(n, 2) == 2;
+      for (uint16_t runs = n[0] | n[1] << 8; ok && runs > 0; runs--)
+      {
+        uint8_t r[4];
+        ok = m_source.read(r, 4) == 4;
+        uint16_t first = r[0] | r[1] << 8;
+        uint16_t count = r[2] | r[3] << 8;
+        ok = ok && first <= m_num_leds && count <= m_num_leds - first && decodeLeds(strip, first, count);
+      }
+    }
+
+    if (!ok)
+    { // corrupt file
+      m_finished = true;
+      m_valid = false;
+      return false;
+    }
+    m_frame++;
+    return true;
+  }
+
+  /**
+   * decode all frames due since the last call
+   * @returns true if at least one frame has been decoded
+  */
+  bool render(Adressable_LED_Strip &strip)
+  {
+    uint32_t now = micros();
+    m_elapsed += m_started ? now - m_last_render : m_frame_time;
+    m_last_render = now;
+    m_started = true;
+
+    bool decoded = false;
+    for (uint8_t i = 0; i < MAX_CATCH_UP && m_elapsed >= m_frame_time; i++)
+    {
+      decoded |= step(strip);
+      m_elapsed -= m_frame_time;
+    }
+    if (m_elapsed >= m_frame_time)
+      m_elapsed %= m_frame_time;
+    return decoded;
+  }
+
+  /**
+   * @returns time in ms until the next frame is due, LED_Strip::NEVER if the animation has ended
+  */
+  uint32_t nextUpdateDue()
+  {
+    if (m_finished || !m_valid)
+      return LED_Strip::NEVER;
+    if (!m_started)
+      return 0;
+    uint32_t elapsed = m_elapsed + (micros() - m_last_render);
+    return elapsed >= m_frame_time ? 0 : (m_frame_time - elapsed) / 1000;
+  }
+
+  inline bool isFinished()
+  {
+    return m_finished;
+  }
+
+  inline bool isValid()
+  {
+    return m_valid;
+  }
+
+  inline uint16_t getFps()
+  {
+    return m_fps;
+  }
+
+  inline uint16_t getNumLeds()
+  {
+    return m_num_leds;
+  }
+
+  inline uint32_t getFrame()
+  {
+    return m_frame;
+  }
+};
+
+/**
+ * writes animation files, runs on the device or on a host
+ * each frame is compared to the previous one and stored as delta frame if that is smaller than a keyframe
+*/
+class LED_Animation_Encoder
+{
+protected:
+  // Print counting bytes only, used to compare frame sizes
+  class Counter : public Print
+  {
+  public:
+    size_t bytes = 0;
+
+    size_t write(uint8_t) override
+    {
+      bytes++;
+      return 1;
+    }
+
+    size_t write(const uint8_t *, size_t size) override
+    {
+      bytes += size;
+      return size;
+    }
+  };
+
+  Print &m_out;
+  uint16_t m_num_leds;
+  CRGB *m_prev;                 // previous frame
+  uint16_t m_keyframe_interval; // force a keyframe every n frames so playback can recover, 0 -> never
+  uint32_t m_frame = 0;
+  size_t m_bytes = 0;
+
+  static inline size_t write16(Print &out, const uint16_t v)
+  {
+    uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+    return out.write(b, 2);
+  }
+
+  // leds with a gap of less than this many unchanged leds are joined into one run
+  static const uint8_t MIN_GAP = 3;
+
+  /**
+   * find next run of changed leds starting at or after i
+   * @returns false if no led changed after i, else first and end of the run
+  */
+  bool nextRun(const CRGB *frame, uint16_t i, uint16_t &first, uint16_t &end)
+  {
+    while (i < m_num_leds && frame[i] == m_prev[i])
+      i++;
+    if (i >= m_num_leds)
+      return false;
+
+    // extend run until MIN_GAP unchanged leds follow
+    first = i;
+    end = i + 1;
+    for (uint16_t k = end, gap = 0; k < m_num_leds && gap < MIN_GAP; k++)
+    {
+      if (frame[k] == m_prev[k])
+      {
+        gap++;
+      }
+      else
+      {
+        gap = 0;
+        end = k + 1;
+      }
+    }
+    return true;
+  }
+
+  size_t writeDelta(Print &out, const CRGB *frame)
+  {
+    uint16_t runs = 0, first, end;
+    for (uint16_t i = 0; nextRun(frame, i, first, end); i = end)
+      runs++;
+
+    size_t bytes = out.write(LED_ANIMATION_DELTA) + write16(out, runs);
+    for (uint16_t i = 0; nextRun(frame, i, first, end); i = end)
+    {
+      bytes += write16(out, first) + write16(out, end - first);
+      bytes += ledRleEncode(out, end - first, [frame, first](const uint16_t k) -> const CRGB & { return frame[first + k]; });
+    }
+    return bytes;
+  }
+
+public:
+  /**
+   * write header, frames are added with addFrame()
+  */
+  LED_Animation_Encoder(Print &out, const uint16_t num_leds, const uint16_t fps, const uint16_t keyframe_interval = 0)
+      : m_out(out), m_num_leds(num_leds), m_keyframe_interval(keyframe_interval)
+  {
+    m_prev = new CRGB[m_num_leds];
+    uint8_t h[LED_ANIMATION_HEADER] = {'L', 'A', LED_ANIMATION_VERSION, 0,
+                                       (uint8_t)fps, (uint8_t)(fps >> 8),
+                                       (uint8_t)num_leds, (uint8_t)(num_leds >> 8)};
+    m_bytes = m_out.write(h, sizeof(h));
+  }
+
+  ~LED_Animation_Encoder()
+  {
+    delete[] m_prev;
+  }
+
+  /**
+   * append frame of num_leds colors
+   * @returns number of bytes written for this frame
+  */
+  size_t addFrame(const CRGB *frame)
+  {
+    bool key = m_frame == 0 || (m_keyframe_interval && m_frame % m_keyframe_interval == 0);
+    if (!key)
+    { // keyframe if it is smaller than the delta
+      Counter delta, keyframe;
+      writeDelta(delta, frame);
+      keyframe.write(LED_ANIMATION_KEYFRAME);
+      ledRleEncode(keyframe, m_num_leds, [frame](const uint16_t i) -> const CRGB & { return frame[i]; });
+      key = keyframe.bytes < delta.bytes;
+    }
+
+    size_t bytes;
+    if (key)
+    {
+      bytes = m_out.write(LED_ANIMATION_KEYFRAME);
+      bytes += ledRleEncode(m_out, m_num_leds, [frame](const uint16_t i) -> const CRGB & { return frame[i]; });
+    }
+    else
+    {
+      bytes = writeDelta(m_out, frame);
+    }
+
+    memcpy(m_prev, frame, m_num_leds * sizeof(CRGB));
+    m_frame++;
+    m_bytes += bytes;
+    return bytes;
+  }
+
+  inline uint32_t getFrames()
+  {
+    return m_frame;
+  }
+
+  // total file size so far
+  inline size_t getBytes()
+  {
+    return m_bytes;
+  }
+};
+
+#endif //LED_ANIMATION_H
@@ -0,0 +1,237 @@
+#ifndef LED_COMMAND_QUEUE_H
+#define LED_COMMAND_QUEUE_H
+
+#include <atomic>
+
+#include <Adressable_LED_Strip.h>
+
+/**
+ * one queued change of a strip
+*/
+struct LED_Command
+{
+  enum TYPE : uint8_t
+  {
+    COLOR,      // setColor(color)
+    BRIGHTNESS, // setBrightness(value)
+    POWER,      // setPower(value)
+    PIXEL       // setSingleColor(color, index)
+  };
+
+  TYPE type;
+  uint8_t value;
+  uint16_t index;
+  CRGB color;
+};
+
+/**
+ * lock free single producer single consumer queue of strip changes
+ * one thread or callback queues commands and commits them, the strip applies all committed commands at the start
+ * of its next frame, so the output never shows a partly applied group of commands
+ * repeated commands are coalesced when applied: only the last color, brightness and power are set,
+ * only the last color of each pixel is set and pixels changed before the last color command are skipped
+ * because the color replaces them
+ *
+ * example from a network callback:
+ *   queue.setSingleColor(c, 3).setSingleColor(c, 4).commit();
+ *
+ * @param SIZE number of commands that fit into the queue, power of 2
+*/
+template <uint16_t SIZE = 64>
+class LED_Command_Queue : public LED_Command_Buffer
+{
+  static_assert(SIZE && !(SIZE & (SIZE - 1)) && SIZE <= 0x8000, "SIZE has to be a power of 2 up to 32768");
+
+protected:
+  Adressable_LED_Strip &m_strip;
+  LED_Command m_commands[SIZE];
+
+  // free running positions, only the lowest bits index m_commands
+  std::atomic<uint16_t> m_head; // end of committed commands, written by producer
+  std::atomic<uint16_t> m_tail; // end of applied commands, written by consumer
+  uint16_t m_staged;            // end of queued but uncommitted commands, producer only
+  bool m_overflow = false;      // a command of the staged group did not fit, producer only
+
+  uint32_t m_dropped = 0;   // groups discarded because the queue was full, producer only
+  uint32_t m_applied = 0;   // commands applied to the strip, consumer only
+  uint32_t m_coalesced = 0; // commands skipped because a later command replaced them, consumer only
+
+  // pixel indices already set while applying, open addressing with linear probing, consumer only
+  static const uint16_t NO_PIXEL = 0xFFFF; // empty slot, no strip has a led with this index
+  uint16_t m_pixels_set[SIZE];
+
+  /**
+   * remember pixel index i for the commands applied now
+   * @returns false if a later command already set the pixel
+  */
+  bool markPixel(const uint16_t i)
+  {
+    uint16_t slot = i & (SIZE - 1);
+    while (m_pixels_set[slot] != NO_PIXEL)
+    {
+      if (m_pixels_set[slot] == i)
+        return false;
+      slot = (slot + 1) & (SIZE - 1);
+    }
+    m_pixels_set[slot] = i;
+    return true;
+  }
+
+  LED_Command_Queue &push(const LED_Command &command)
+  {
+    if ((uint16_t)(m_staged - m_tail.load(std::memory_order_acquire)) >= SIZE)
+    {
+      m_overflow = true;
+      return *this;
+    }
+    m_commands[m_staged & (SIZE - 1)] = command;
+    m_staged++;
+    return *this;
+  }
+
+public:
+  LED_Command_Queue(Adressable_LED_Strip &strip) : m_strip(strip), m_head(0), m_tail(0), m_staged(0)
+  {
+    m_strip.setCommandBuffer(this);
+  }
+
+  ~LED_Command_Queue()
+  {
+    m_strip.setCommandBuffer(nullptr);
+  }
+
+  // producer side, commands take effect after commit()
+
+  inline LED_Command_Queue &setColor(const CRGB &color)
+  {
+    return push({LED_Command::COLOR, 0, 0, color});
+  }
+
+  inline LED_Command_Queue &setBrightness(const uint8_t brightness)
+  {
+    return push({LED_Command::BRIGHTNESS, brightness, 0, CRGB(0)});
+  }
+
+  inline LED_Command_Queue &setPower(const bool power)
+  {
+    return push({LED_Command::POWER, power, 0, CRGB(0)});
+  }
+
+  inline LED_Command_Queue &setSingleColor(const CRGB &color, const uint16_t i)
+  {
+    return push({LED_Command::PIXEL, 0, i, color});
+  }
+
+  /**
+   * hand all commands queued since the last commit to the strip, they are applied in the same frame
+   * @returns false if the queue overflowed, the whole group is discarded then
+  */
+  bool commit()
+  {
+    if (m_overflow)
+    {
+      m_staged = m_head.load(std::memory_order_relaxed);
+      m_overflow = false;
+      m_dropped++;
+      return false;
+    }
+    m_head.store(m_staged, std::memory_order_release);
+    return true;
+  }
+
+  inline uint32_t getDropped()
+  {
+    return m_dropped;
+  }
+
+  // consumer side, called by the strip
+
+  void apply() override
+  {
+    const uint16_t head = m_head.load(std::memory_order_acquire);
+    const uint16_t tail = m_tail.load(std::memory_order_relaxed);
+    if (head == tail)
+      return;
+
+    // find the commands that survive coalescing
+    uint16_t last_color = tail, last_brightness = tail, last_power = tail;
+    bool color = false, brightness = false, power = false;
+    for (uint16_t i = tail; i != head; i++)
+    {
+      switch (m_commands[i & (SIZE - 1)].type)
+      {
+      case LED_Command::COLOR:
+        last_color = i;
+        color = true;
+        break;
+      case LED_Command::BRIGHTNESS:
+        last_brightness = i;
+        brightness = true;
+        break;
+      case LED_Command::POWER:
+        last_power = i;
+        power = true;
+        break;
+      default:
+        break;
+      }
+    }
+
+    uint16_t applied = 0;
+    if (brightness)
+    {
+      m_strip.setBrightness(m_commands[last_brightness & (SIZE - 1)].value);
+      applied++;
+    }
+    if (power)
+    {
+      m_strip.setPower(m_commands[last_power & (SIZE - 1)].value);
+      applied++;
+    }
+
+    // the last color switches the strip to single mode, only pixels changed after it are applied
+    uint16_t first = tail;
+    if (color)
+    {
+      m_strip.setColor(m_commands[last_color & (SIZE - 1)].color);
+      applied++;
+      first = last_color + 1;
+    }
+
+    // newest pixels first, so older commands of the same pixel are skipped
+    if (first != head)
+    {
+      memset(m_pixels_set, 0xFF, sizeof(m_pixels_set));
+      for (uint16_t i = head; i != first;)
+      {
+        const LED_Command &c = m_commands[--i & (SIZE - 1)];
+        if (c.type == LED_Command::PIXEL && c.index != NO_PIXEL && markPixel(c.index))
+        {
+          m_strip.setSingleColor(c.color, c.index);
+          applied++;
+        }
+      }
+    }
+
+    m_applied += applied;
+    m_coalesced += (uint16_t)(head - tail) - applied;
+    m_tail.store(head, std::memory_order_release);
+  }
+
+  bool pending() override
+  {
+    return m_head.load(std::memory_order_acquire) != m_tail.load(std::memory_order_relaxed);
+  }
+
+  inline uint32_t getApplied()
+  {
+    return m_applied;
+  }
+
+  inline uint32_t getCoalesced()
+  {
+    return m_coalesced;
+  }
+};
+
+#endif //LED_COMMAND_QUEUE_H
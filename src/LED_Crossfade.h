@@ -0,0 +1,152 @@
+#ifndef LED_CROSSFADE_H
+#define LED_CROSSFADE_H
+
+#include <FastLED.h>
+
+/**
+ * smooth transition of an entire addressable frame from a start frame to a target frame
+ * the start frame is stored as separate channel arrays and all leds share one progress value
+ * so a transition costs 3 bytes per led instead of one filter object per led and channel
+*/
+class LED_Crossfade
+{
+protected:
+  uint8_t *m_start_r = nullptr; // start frame, one array per channel
+  uint8_t *m_start_g = nullptr;
+  uint8_t *m_start_b = nullptr;
+  uint16_t m_num_leds = 0;
+
+  unsigned long m_start_time = 0;
+  uint16_t m_duration = 0;
+  uint16_t m_progress = 256; // 0 == start frame, 256 == target frame
+  bool m_active = false;
+
+  /**
+   * integer linear interpolation between a and b
+   * @param p progress between 0 and 256
+  */
+  static inline uint8_t lerp(const uint8_t a, const uint8_t b, const uint16_t p)
+  {
+    return a + (((int)(b - a) * p) >> 8);
+  }
+
+  /**
+   * (re)allocate start frame only if size changed
+  */
+  void resize(const uint16_t num_leds)
+  {
+    if (num_leds == m_num_leds)
+      return;
+    delete[] m_start_r;
+    delete[] m_start_g;
+    delete[] m_start_b;
+    m_start_r = new uint8_t[num_leds];
+    m_start_g = new uint8_t[num_leds];
+    m_start_b = new uint8_t[num_leds];
+    m_num_leds = num_leds;
+    m_progress = 256; // new arrays hold no start frame yet
+    m_active = false;
+  }
+
+  inline void setStart(const uint16_t i, const CRGB &target)
+  {
+    CRGB c = blend(i, target);
+    m_start_r[i] = c.r;
+    m_start_g[i] = c.g;
+    m_start_b[i] = c.b;
+  }
+
+  void start(const uint16_t duration)
+  {
+    m_start_time = millis();
+    m_duration = duration;
+    m_progress = 0;
+    m_active = duration > 0;
+  }
+
+public:
+  ~LED_Crossfade()
+  {
+    delete[] m_start_r;
+    delete[] m_start_g;
+    delete[] m_start_b;
+  }
+
+  /**
+   * start a new transition from the currently visible frame
+   * @param frame current target frame, a running transition continues from its blended state
+   * @param num_leds number of leds in frame
+   * @param duration transition time in ms
+  */
+  void begin(const CRGB *frame, const uint16_t num_leds, const uint16_t duration)
+  {
+    resize(num_leds);
+    for (uint16_t i = 0; i < m_num_leds; i++)
+    {
+      setStart(i, frame[i]);
+    }
+    start(duration);
+  }
+
+  /**
+   * start a new transition from a frame with all leds in one color
+   * @param color current target color of all leds, a running transition continues from its blended state
+   * @param num_leds number of leds in frame
+   * @param duration transition time in ms
+  */
+  void begin(const CRGB &color, const uint16_t num_leds, const uint16_t duration)
+  {
+    resize(num_leds);
+    for (uint16_t i = 0; i < m_num_leds; i++)
+    {
+      setStart(i, color);
+    }
+    start(duration);
+  }
+
+  /**
+   * calculate progress once per frame
+   * @returns true if the frame has to be blended, including the frame that finishes the transition
+  */
+  bool update()
+  {
+    if (!m_active)
+      return false;
+
+    unsigned long elapsed = millis() - m_start_time;
+    if (elapsed >= m_duration)
+    {
+      m_progress = 256;
+      m_active = false;
+    }
+    else
+    {
+      m_progress = (elapsed << 8) / m_duration;
+    }
+    return true;
+  }
+
+  inline bool isActive()
+  {
+    return m_active;
+  }
+
+  inline size_t getHeapUsage()
+  {
+    return 3 * m_num_leds;
+  }
+
+  /**
+   * blend start color of led i towards target using the current progress
+  */
+  inline CRGB blend(const uint16_t i, const CRGB &target) const
+  {
+    if (m_progress >= 256 || i >= m_num_leds)
+      return target;
+    return CRGB(lerp(m_start_r[i], target.r, m_progress),
+                lerp(m_start_g[i], target.g, m_progress),
+                lerp(m_start_b[i], target.b, m_progress));
+  }
+};
+
+#endif //LED_CROSSFADE_H
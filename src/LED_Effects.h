@@ -0,0 +1,317 @@
+#ifndef LED_EFFECTS_H
+#define LED_EFFECTS_H
+
+#include <LED_Strip.h>
+
+/**
+ * base class for effects, EFFECT is the derived class (CRTP)
+ * the derived class implements template <class STRIP> void step(STRIP &strip) which advances the effect by one step
+ * render() calls step() once per elapsed interval so the speed does not depend on how often it is called
+*/
+template <class EFFECT>
+class LED_Effect
+{
+public:
+  static const uint8_t MAX_CATCH_UP = 4; // maximum steps per render, older steps are dropped
+
+protected:
+  uint16_t m_interval; // time per step in ms
+  uint32_t m_elapsed = 0;
+
+public:
+  LED_Effect(const uint16_t interval = 20) : m_interval(interval) {}
+
+  inline EFFECT &setInterval(const uint16_t interval)
+  {
+    m_interval = interval;
+    return *static_cast<EFFECT *>(this);
+  }
+
+  inline uint16_t getInterval()
+  {
+    return m_interval;
+  }
+
+  /**
+   * advance effect by the time elapsed since the last render
+   * @param dt elapsed time in ms
+  */
+  template <class STRIP>
+  void render(STRIP &strip, const uint32_t dt)
+  {
+    m_elapsed += dt;
+    if (m_interval == 0)
+    { // no interval -> one step per render
+      static_cast<EFFECT *>(this)->step(strip);
+      m_elapsed = 0;
+      return;
+    }
+
+    for (uint8_t i = 0; i < MAX_CATCH_UP && m_elapsed >= m_interval; i++)
+    {
+      static_cast<EFFECT *>(this)->step(strip);
+      m_elapsed -= m_interval;
+    }
+    m_elapsed %= m_interval;
+  }
+
+  /**
+   * @param since time in ms since the last render
+   * @returns time in ms until the next step is due, 0 if it is due now
+  */
+  uint32_t nextStepDue(const uint32_t since)
+  {
+    if (m_interval == 0)
+      return 0;
+    uint32_t elapsed = m_elapsed + since;
+    return elapsed >= m_interval ? 0 : m_interval - elapsed;
+  }
+};
+
+// random white sparkles fading out
+class Sparkle_Effect : public LED_Effect<Sparkle_Effect>
+{
+public:
+  template <class STRIP>
+  void step(STRIP &strip)
+  {
+    strip.setMode(LED_Strip::MANY);
+
+    strip.fadeall(220);
+    int id = map(random8(), 0, 255, 0, strip.getNumLeds() - 1);
+    strip.setSingleColor(CRGB(255, 255, random8()), id);
+  }
+};
+
+// repeating red green blue sections
+class SectionColor_Effect : public LED_Effect<SectionColor_Effect>
+{
+protected:
+  uint16_t m_section_size = 1;
+
+public:
+  inline SectionColor_Effect &setSectionSize(const uint16_t size)
+  {
+    m_section_size = size;
+    return *this;
+  }
+
+  template <class STRIP>
+  void step(STRIP &strip)
+  {
+    if (m_section_size == 0)
+      return;
+
+    strip.setMode(LED_Strip::MANY);
+
+    for (uint16_t i = 0; i < strip.getNumLeds(); i++)
+    {
+      switch ((i / m_section_size) % 3)
+      {
+      case 0:
+        strip.setSingleColor(CRGB::Red, i);
+        break;
+      case 1:
+        strip.setSingleColor(CRGB::Green, i);
+        break;
+      case 2:
+        strip.setSingleColor(CRGB::Blue, i);
+        break;
+      }
+    }
+  }
+};
+
+// rainbow moving along the strip
+class SpectrumHue_Effect : public LED_Effect<SpectrumHue_Effect>
+{
+protected:
+  uint8_t m_hue = 0;
+
+public:
+  template <class STRIP>
+  void step(STRIP &strip)
+  {
+    strip.setMode(LED_Strip::MANY);
+
+    strip.scroll(1); // move every led by one without copying
+    strip.setSingleColor(CHSV(m_hue++, 255, 255), 0);
+  }
+};
+
+// single point bouncing between both ends of the strip leaving a fading trail
+class MovingPoint_Effect : public LED_Effect<MovingPoint_Effect>
+{
+protected:
+  CRGB m_color = CRGB::White;
+  int m_position = 0;
+  bool m_direction = true;
+
+public:
+  inline MovingPoint_Effect &setColor(const CRGB &c)
+  {
+    m_color = c;
+    return *this;
+  }
+
+  template <class STRIP>
+  void step(STRIP &strip)
+  {
+    strip.setMode(LED_Strip::MANY);
+
+    strip.setSingleColor(m_color, m_position);
+    strip.fadeall(250);
+    if (m_direction)
+    {
+      m_position++;
+      if (m_position >= strip.getNumLeds())
+      {
+        m_direction = false;
+        m_position = strip.getNumLeds() - 1;
+      }
+    }
+    else
+    {
+      m_position--;
+      if (m_position < 0)
+      {
+        m_direction = true;
+        m_position = 0;
+      }
+    }
+  }
+};
+
+// moving point changing its hue every step
+class MovingHue_Effect : public LED_Effect<MovingHue_Effect>
+{
+protected:
+  MovingPoint_Effect m_point;
+  uint8_t m_hue = 0;
+
+public:
+  template <class STRIP>
+  void step(STRIP &strip)
+  {
+    m_point.setColor(CHSV(m_hue++, 255, 255)).step(strip);
+  }
+};
+
+/**
+ * compile time list of effects, each effect keeps its own state
+*/
+template <class... EFFECTS>
+class LED_Effect_List
+{
+public:
+  template <class STRIP>
+  inline void render(const uint8_t, STRIP &, const uint32_t) {}
+
+  inline uint32_t nextStepDue(const uint8_t, const uint32_t)
+  {
+    return LED_Strip::NEVER;
+  }
+};
+
+template <class FIRST, class... REST>
+class LED_Effect_List<FIRST, REST...>
+{
+protected:
+  FIRST m_effect;
+  LED_Effect_List<REST...> m_rest;
+
+public:
+  template <class STRIP>
+  inline void render(const uint8_t id, STRIP &strip, const uint32_t dt)
+  {
+    if (id == 0)
+      m_effect.render(strip, dt);
+    else
+      m_rest.render(id - 1, strip, dt);
+  }
+
+  inline uint32_t nextStepDue(const uint8_t id, const uint32_t since)
+  {
+    return id == 0 ? m_effect.nextStepDue(since) : m_rest.nextStepDue(id - 1, since);
+  }
+
+  inline FIRST &get(FIRST *)
+  {
+    return m_effect;
+  }
+
+  template <class EFFECT>
+  inline EFFECT &get(EFFECT *e)
+  {
+    return m_rest.get(e);
+  }
+};
+
+/**
+ * runs one of several effects registered at compile time
+ * the effect is selected by its position in EFFECTS at runtime, dispatch happens once per render and not per led
+ * example: LED_Effect_Engine<Sparkle_Effect, SpectrumHue_Effect> engine; engine.select(1); engine.render(strip);
+*/
+template <class... EFFECTS>
+class LED_Effect_Engine
+{
+public:
+  static const uint8_t NUM_EFFECTS = sizeof...(EFFECTS);
+
+protected:
+  LED_Effect_List<EFFECTS...> m_effects;
+  uint8_t m_active = 0;
+  unsigned long m_last_render = 0;
+  bool m_started = false;
+
+public:
+  /**
+   * select effect by its position in EFFECTS
+   * @returns false if id is out of range
+  */
+  bool select(const uint8_t id)
+  {
+    if (id >= NUM_EFFECTS)
+      return false;
+    m_active = id;
+    return true;
+  }
+
+  inline uint8_t getActive()
+  {
+    return m_active;
+  }
+
+  // access effect state for configuration
+  template <class EFFECT>
+  inline EFFECT &get()
+  {
+    return m_effects.get((EFFECT *)nullptr);
+  }
+
+  /**
+   * advance active effect by the time elapsed since the last call
+  */
+  template <class STRIP>
+  void render(STRIP &strip)
+  {
+    unsigned long now = millis();
+    uint32_t dt = m_started ? now - m_last_render : 0;
+    m_last_render = now;
+    m_started = true;
+
+    m_effects.render(m_active, strip, dt);
+  }
+
+  /**
+   * @returns time in ms until the active effect takes its next step, 0 if it is due now
+  */
+  uint32_t nextUpdateDue()
+  {
+    if (!m_started)
+      return 0;
+    return m_effects.nextStepDue(m_active, millis() - m_last_render);
+  }
+};
+
+#endif //LED_EFFECTS_H
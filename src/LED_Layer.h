@@ -0,0 +1,363 @@
+#ifndef LED_LAYER_H
+#define LED_LAYER_H
+
+#include <Adressable_LED_Strip.h>
+
+/**
+ * one layer of an LED_Compositor
+ * provides the part of the strip interface used by effects, so effects can render into a layer
+ * leds outside of the range written since the last clear() are transparent and skipped by the compositor
+*/
+class LED_Layer
+{
+  template <uint8_t>
+  friend class LED_Compositor;
+
+public:
+  enum BLEND
+  {
+    ALPHA,   // layer covers leds below
+    ADD,     // saturating sum, black is transparent
+    MAX,     // brighter channel wins, black is transparent
+    MULTIPLY // leds below are filtered by the layer, white is transparent
+  };
+
+  /**
+   * blend count colors of src onto dst with 8 bit integer math
+   * @param opacity 0 == src invisible, 255 == full strength
+  */
+  static void blend(CRGB *dst, const CRGB *src, const uint16_t count, const BLEND mode, const uint8_t opacity)
+  {
+    uint8_t *d = (uint8_t *)dst;
+    const uint8_t *s = (const uint8_t *)src;
+    const uint16_t n = count * 3;
+
+    if (opacity == 255)
+    {
+      switch (mode)
+      {
+      case BLEND::ALPHA:
+        memcpy(d, s, n);
+        return;
+      case BLEND::ADD:
+        bulkAdd8(d, s, n);
+        return;
+      case BLEND::MAX:
+        bulkMax8(d, s, n);
+        return;
+      case BLEND::MULTIPLY:
+        for (uint16_t i = 0; i < n; i++)
+          d[i] = scale8(d[i], s[i]);
+        return;
+      }
+    }
+
+    const uint16_t a = opacity + (opacity >> 7); // 0 - 256, so both ends are exact
+    for (uint16_t i = 0; i < n; i++)
+    {
+      switch (mode)
+      {
+      case BLEND::ALPHA:
+        d[i] = (d[i] * (256 - a) + s[i] * a) >> 8;
+        break;
+      case BLEND::ADD:
+        d[i] = qadd8(d[i], scale8(s[i], opacity));
+        break;
+      case BLEND::MAX:
+        d[i] = max(d[i], scale8(s[i], opacity));
+        break;
+      case BLEND::MULTIPLY:
+        d[i] = scale8(d[i], 255 - scale8(255 - s[i], opacity));
+        break;
+      }
+    }
+  }
+
+protected:
+  CRGB *m_leds;
+  uint16_t m_num_leds;
+  uint16_t m_head = 0; // ring buffer like the raw buffer of a strip, allows scrolling without moving data
+
+  uint16_t m_dirty_min; // leds changed since last compose, empty if min > max
+  uint16_t m_dirty_max = 0;
+  uint16_t m_active_min; // leds written since last clear, empty if min > max
+  uint16_t m_active_max = 0;
+
+  BLEND m_blend = BLEND::ALPHA;
+  uint8_t m_opacity = 255;
+  bool m_visible = true;
+
+  inline void markDirty(const uint16_t first, const uint16_t last)
+  {
+    if (first < m_dirty_min)
+      m_dirty_min = first;
+    if (last > m_dirty_max)
+      m_dirty_max = last;
+  }
+
+  // mark leds as written, they become visible
+  inline void markActive(const uint16_t first, const uint16_t last)
+  {
+    if (first < m_active_min)
+      m_active_min = first;
+    if (last > m_active_max)
+      m_active_max = last;
+    markDirty(first, last);
+  }
+
+  inline bool isActive()
+  {
+    return m_active_min <= m_active_max;
+  }
+
+  // visible leds have to be composed again, e.g. after changing opacity
+  inline void markActiveDirty()
+  {
+    if (isActive())
+      markDirty(m_active_min, m_active_max);
+  }
+
+  inline uint16_t index(const uint16_t i)
+  {
+    uint32_t p = (uint32_t)i + m_head;
+    return p >= m_num_leds ? p - m_num_leds : p;
+  }
+
+public:
+  LED_Layer(const uint16_t p_nleds)
+  {
+    m_num_leds = max((uint16_t)1, p_nleds);
+    m_leds = new CRGB[m_num_leds];
+    bulkFill(m_leds, m_num_leds, CRGB(0));
+    m_dirty_min = m_num_leds;
+    m_active_min = m_num_leds;
+  }
+
+  ~LED_Layer()
+  {
+    delete[] m_leds;
+  }
+
+  inline LED_Layer &setBlend(const BLEND blend)
+  {
+    m_blend = blend;
+    markActiveDirty();
+    return *this;
+  }
+
+  inline BLEND getBlend()
+  {
+    return m_blend;
+  }
+
+  inline LED_Layer &setOpacity(const uint8_t opacity)
+  {
+    if (opacity != m_opacity)
+    {
+      m_opacity = opacity;
+      markActiveDirty();
+    }
+    return *this;
+  }
+
+  inline uint8_t getOpacity()
+  {
+    return m_opacity;
+  }
+
+  inline LED_Layer &setVisible(const bool visible)
+  {
+    if (visible != m_visible)
+    {
+      m_visible = visible;
+      markActiveDirty();
+    }
+    return *this;
+  }
+
+  inline bool getVisible()
+  {
+    return m_visible;
+  }
+
+  /**
+   * make all leds transparent
+  */
+  LED_Layer &clear()
+  {
+    markActiveDirty();
+    bulkFill(m_leds, m_num_leds, CRGB(0));
+    m_head = 0;
+    m_active_min = m_num_leds;
+    m_active_max = 0;
+    return *this;
+  }
+
+  // strip interface for effects
+
+  // layers have no modes, leds are always addressed individually
+  inline LED_Layer &setMode(const LED_Strip::MODE)
+  {
+    return *this;
+  }
+
+  inline uint16_t getNumLeds()
+  {
+    return m_num_leds;
+  }
+
+  LED_Layer &setSingleColor(const CRGB &color, const int i)
+  {
+    if (i >= m_num_leds || i < 0)
+      return *this;
+    m_leds[index(i)] = color;
+    markActive(i, i);
+    return *this;
+  }
+
+  inline CRGB getSingleColor(const int i)
+  {
+    if (i >= m_num_leds || i < 0)
+      return CRGB(0);
+    return m_leds[index(i)];
+  }
+
+  LED_Layer &setRangeColor(const CRGB &color, const uint16_t first, uint16_t count)
+  {
+    if (first >= m_num_leds || count == 0)
+      return *this;
+    count = min(count, (uint16_t)(m_num_leds - first));
+
+    uint16_t p = index(first);
+    uint16_t part = min(count, (uint16_t)(m_num_leds - p));
+    bulkFill(&m_leds[p], part, color);
+    bulkFill(m_leds, count - part, color);
+    markActive(first, first + count - 1);
+    return *this;
+  }
+
+  LED_Layer &fadeall(const uint8_t amount = 253)
+  {
+    bulkScale8((uint8_t *)m_leds, m_num_leds * 3, amount);
+    markActiveDirty();
+    return *this;
+  }
+
+  /**
+   * move all leds by n positions like LED_Strip::scroll()
+  */
+  LED_Layer &scroll(const int16_t n)
+  {
+    if (!isActive())
+      return *this;
+
+    int32_t head = ((int32_t)m_head - n) % m_num_leds;
+    m_head = head < 0 ? head + m_num_leds : head;
+    markActive(0, m_num_leds - 1); // written leds may be anywhere now
+    return *this;
+  }
+};
+
+/**
+ * blends a stack of layers into the raw buffer of a strip
+ * only leds changed in any layer since the last compose are blended again, invisible layers and
+ * leds outside of the written range of a layer are skipped
+ * layers are drawn in the order they were added, the first layer is at the bottom
+*/
+template <uint8_t MAX_LAYERS = 4>
+class LED_Compositor
+{
+protected:
+  Adressable_LED_Strip &m_strip;
+  LED_Layer *m_layers[MAX_LAYERS];
+  uint8_t m_num_layers = 0;
+  CRGB m_background = 0;
+  bool m_full = true; // compose all leds, e.g. after adding a layer
+
+  /**
+   * blend layer onto count leds starting at first
+  */
+  void blendLayer(LED_Layer &layer, CRGB *out, uint16_t first, uint16_t count)
+  {
+    if (!layer.m_visible || layer.m_opacity == 0 || !layer.isActive())
+      return;
+
+    // skip transparent leds outside of the written range
+    uint16_t last = min((uint16_t)(first + count - 1), layer.m_active_max);
+    if (layer.m_active_min > first)
+    {
+      out += layer.m_active_min - first;
+      first = layer.m_active_min;
+    }
+    if (first > last)
+      return;
+    count = last - first + 1;
+
+    // split at the end of the ring buffer of the layer
+    uint16_t p = layer.index(first);
+    uint16_t part = min(count, (uint16_t)(layer.m_num_leds - p));
+    LED_Layer::blend(out, &layer.m_leds[p], part, layer.m_blend, layer.m_opacity);
+    if (part < count)
+      LED_Layer::blend(out + part, layer.m_leds, count - part, layer.m_blend, layer.m_opacity);
+  }
+
+public:
+  LED_Compositor(Adressable_LED_Strip &strip) : m_strip(strip) {}
+
+  /**
+   * add layer on top of all others, the layer needs as many leds as the strip
+   * @returns false if no more layers can be added
+  */
+  bool add(LED_Layer &layer)
+  {
+    if (m_num_layers >= MAX_LAYERS || layer.getNumLeds() != m_strip.getNumLeds())
+      return false;
+    m_layers[m_num_layers++] = &layer;
+    m_full = true;
+    return true;
+  }
+
+  // color below all layers
+  LED_Compositor &setBackground(const CRGB &color)
+  {
+    m_background = color;
+    m_full = true;
+    return *this;
+  }
+
+  /**
+   * blend changed leds of all layers into the strip, call before updating the strip
+   * @returns true if leds of the strip have been written
+  */
+  bool compose()
+  {
+    uint16_t n = m_strip.getNumLeds();
+    uint16_t first = m_full ? 0 : n;
+    uint16_t last = m_full ? n - 1 : 0;
+    for (uint8_t l = 0; l < m_num_layers; l++)
+    {
+      first = min(first, m_layers[l]->m_dirty_min);
+      last = max(last, m_layers[l]->m_dirty_max);
+    }
+    if (first > last)
+      return false;
+
+    m_strip.editRaw(first, last - first + 1, [this](CRGB *out, const uint16_t start, const uint16_t count) {
+      bulkFill(out, count, m_background);
+      for (uint8_t l = 0; l < m_num_layers; l++)
+      {
+        blendLayer(*m_layers[l], out, start, count);
+      }
+    });
+
+    for (uint8_t l = 0; l < m_num_layers; l++)
+    {
+      m_layers[l]->m_dirty_min = n;
+      m_layers[l]->m_dirty_max = 0;
+    }
+    m_full = false;
+    return true;
+  }
+};
+
+#endif //LED_LAYER_H
@@ -0,0 +1,233 @@
+#ifndef LED_MATRIX_H
+#define LED_MATRIX_H
+
+#include <Adressable_LED_Strip.h>
+
+/**
+ * 2D view of an adressable strip wired as one or more matrix panels
+ * the wiring is resolved once into a lookup table used by the renderer, so leds are stored row by row,
+ * setting pixels, rows and columns costs the same as on a plain strip and only changed pixels are rendered
+ * scrolling moves the origin of the lookup instead of copying leds
+ *
+ * panels are chained row by row starting at the top left panel, all panels share size and wiring
+ * width and height of the whole matrix are limited to 255, panels beyond that are left out
+*/
+class LED_Matrix
+{
+public:
+  enum ROTATION
+  {
+    ROTATE_0,   // first led top left, rows run left to right
+    ROTATE_90,  // panel turned clockwise, first led top right
+    ROTATE_180, // first led bottom right
+    ROTATE_270  // first led bottom left
+  };
+
+protected:
+  Adressable_LED_Strip &m_strip;
+  LED_Pixel_Map m_map;
+  uint16_t *m_output = nullptr; // output led of each pixel, row by row
+
+  // logical index of led x, y including the origin
+  inline uint16_t index(const uint8_t x, const uint8_t y)
+  {
+    uint16_t sx = x + m_map.origin_x;
+    if (sx >= m_map.width)
+      sx -= m_map.width;
+    uint16_t sy = y + m_map.origin_y;
+    if (sy >= m_map.height)
+      sy -= m_map.height;
+    return sy * m_map.width + sx;
+  }
+
+  inline bool contains(const int x, const int y)
+  {
+    return x >= 0 && y >= 0 && x < m_map.width && y < m_map.height;
+  }
+
+public:
+  /**
+   * @param tile_width number of columns of one panel
+   * @param tile_height number of rows of one panel
+   * @param tiles_x number of panels side by side, reduced if the matrix would be wider than 255
+   * @param tiles_y number of panels on top of each other, reduced if the strip has not enough leds or the matrix would be higher than 255
+   * @param serpentine true if every second row of a panel is wired back to front
+   * @param rotation orientation of the wiring of each panel
+  */
+  LED_Matrix(Adressable_LED_Strip &strip, const uint8_t tile_width, const uint8_t tile_height,
+             uint8_t tiles_x = 1, uint8_t tiles_y = 1, const bool serpentine = true, const ROTATION rotation = ROTATION::ROTATE_0)
+      : m_strip(strip)
+  {
+    const uint8_t tw = max((uint8_t)1, tile_width);
+    const uint8_t th = max((uint8_t)1, tile_height);
+    const uint16_t tile_size = tw * th;
+    tiles_x = constrain(tiles_x, 1, 255 / tw);
+    tiles_y = min((uint16_t)min(tiles_y, (uint8_t)(255 / th)), (uint16_t)(strip.getNumLeds() / (tile_size * tiles_x)));
+
+    m_map.width = tw * tiles_x;
+    m_map.height = th * tiles_y;
+    m_map.size = m_map.width * m_map.height;
+    m_map.origin_x = 0;
+    m_map.origin_y = 0;
+    m_output = new uint16_t[max((uint16_t)1, m_map.size)];
+    m_map.output = m_output;
+
+    // wiring of a panel turned by 90 or 270 degrees runs along its columns
+    const bool turned = rotation == ROTATION::ROTATE_90 || rotation == ROTATION::ROTATE_270;
+    const uint8_t wire_cols = turned ? th : tw;
+
+    for (uint16_t o = 0; o < m_map.size; o++)
+    {
+      uint16_t tile = o / tile_size;
+      uint16_t k = o - tile * tile_size;
+      uint8_t r = k / wire_cols;
+      uint8_t c = k - r * wire_cols;
+      if (serpentine && (r & 1))
+        c = wire_cols - 1 - c;
+
+      uint8_t x, y;
+      switch (rotation)
+      {
+      case ROTATION::ROTATE_90:
+        x = tw - 1 - r;
+        y = c;
+        break;
+      case ROTATION::ROTATE_180:
+        x = tw - 1 - c;
+        y = th - 1 - r;
+        break;
+      case ROTATION::ROTATE_270:
+        x = r;
+        y = th - 1 - c;
+        break;
+      default:
+        x = c;
+        y = r;
+        break;
+      }
+      m_output[((tile / tiles_x) * th + y) * m_map.width + (tile % tiles_x) * tw + x] = o;
+    }
+
+    m_strip.setPixelMap(&m_map);
+  }
+
+  ~LED_Matrix()
+  {
+    m_strip.setPixelMap(nullptr);
+    delete[] m_output;
+  }
+
+  inline uint8_t getWidth()
+  {
+    return m_map.width;
+  }
+
+  inline uint8_t getHeight()
+  {
+    return m_map.height;
+  }
+
+  LED_Matrix &setPixel(const int x, const int y, const CRGB &color)
+  {
+    if (contains(x, y))
+      m_strip.setSingleColor(color, index(x, y));
+    return *this;
+  }
+
+  CRGB getPixel(const int x, const int y)
+  {
+    if (!contains(x, y))
+      return CRGB(0);
+    return m_strip.getRawColor(index(x, y));
+  }
+
+  /**
+   * set all leds to one color and reset the origin
+  */
+  LED_Matrix &fill(const CRGB &color)
+  {
+    m_map.origin_x = 0;
+    m_map.origin_y = 0;
+    m_strip.setRangeColor(color, 0, m_map.size);
+    return *this;
+  }
+
+  inline LED_Matrix &clear()
+  {
+    return fill(CRGB(0));
+  }
+
+  LED_Matrix &fillRow(const int y, const CRGB &color)
+  {
+    if (contains(0, y)) // origin only rotates leds within a row
+      m_strip.setRangeColor(color, index(0, y) - m_map.origin_x, m_map.width);
+    return *this;
+  }
+
+  /**
+   * set all leds of row y from left to right
+   * @param colors one color per column
+  */
+  LED_Matrix &setRow(const int y, const CRGB *colors)
+  {
+    if (!contains(0, y))
+      return *this;
+
+    // origin splits the row into two contiguous parts
+    uint16_t start = index(0, y) - m_map.origin_x;
+    uint8_t first = m_map.width - m_map.origin_x;
+    m_strip.editRaw(start, m_map.width, [this, start, first, colors](CRGB *leds, const uint16_t i, const uint16_t n) {
+      for (uint16_t k = 0; k < n; k++)
+      {
+        uint16_t sx = i - start + k; // column in storage
+        leds[k] = colors[sx >= m_map.origin_x ? sx - m_map.origin_x : sx + first];
+      }
+    });
+    return *this;
+  }
+
+  LED_Matrix &fillColumn(const int x, const CRGB &color)
+  {
+    if (!contains(x, 0))
+      return *this;
+    for (uint8_t y = 0; y < m_map.height; y++)
+    {
+      m_strip.setSingleColor(color, index(x, y));
+    }
+    return *this;
+  }
+
+  /**
+   * set all leds of column x from top to bottom
+   * @param colors one color per row
+  */
+  LED_Matrix &setColumn(const int x, const CRGB *colors)
+  {
+    if (!contains(x, 0))
+      return *this;
+    for (uint8_t y = 0; y < m_map.height; y++)
+    {
+      m_strip.setSingleColor(colors[y], index(x, y));
+    }
+    return *this;
+  }
+
+  /**
+   * move the image by dx columns to the right and dy rows down without copying leds
+   * leds shifted out at one edge reappear at the opposite edge
+  */
+  LED_Matrix &scroll(const int16_t dx, const int16_t dy)
+  {
+    if (m_map.size == 0)
+      return *this;
+
+    int16_t ox = ((int16_t)m_map.origin_x - dx) % m_map.width;
+    m_map.origin_x = ox < 0 ? ox + m_map.width : ox;
+    int16_t oy = ((int16_t)m_map.origin_y - dy) % m_map.height;
+    m_map.origin_y = oy < 0 ? oy + m_map.height : oy;
+    m_strip.forceUpdate();
+    return *this;
+  }
+};
+
+#endif //LED_MATRIX_H
@@ -0,0 +1,146 @@
+#ifndef LED_SCHEDULER_H
+#define LED_SCHEDULER_H
+
+#include <LED_Strip.h>
+
+/**
+ * renders multiple strips at a fixed frame rate
+ * call run() as often as possible from loop(), strips are only updated when a frame is due
+ * deadlines are kept in microseconds and compared wrap-safe, late frames are skipped instead of queued
+*/
+template <uint8_t MAX_STRIPS = 8>
+class LED_Scheduler
+{
+public:
+  struct Stats
+  {
+    uint32_t frames = 0;     // rendered frames
+    uint32_t skipped = 0;    // frames dropped because the scheduler fell behind
+    uint32_t overruns = 0;   // frames whose render time exceeded the frame budget
+    uint32_t jitter_min = 0; // lateness of frame start in us
+    uint32_t jitter_max = 0;
+    uint32_t jitter_avg = 0; // moving average over roughly 16 frames
+    uint32_t render_max = 0; // longest render time in us
+  };
+
+protected:
+  LED_Strip *m_strips[MAX_STRIPS];
+  uint8_t m_num_strips = 0;
+
+  uint32_t m_frame_time = 0; // frame budget in us
+  uint32_t m_next_frame = 0; // deadline of next frame in us
+  bool m_started = false;
+
+  Stats m_stats;
+
+public:
+  LED_Scheduler(const uint16_t fps = 60)
+  {
+    setFps(fps);
+  }
+
+  /**
+   * register strip for rendering
+   * @returns false if no more strips can be added
+  */
+  bool add(LED_Strip &strip)
+  {
+    if (m_num_strips >= MAX_STRIPS)
+      return false;
+    m_strips[m_num_strips++] = &strip;
+    return true;
+  }
+
+  LED_Scheduler &setFps(const uint16_t fps)
+  {
+    m_frame_time = 1000000UL / max((uint16_t)1, fps);
+    return *this;
+  }
+
+  /**
+   * render all strips if the next frame is due
+   * @returns true if a frame has been rendered
+  */
+  bool run()
+  {
+    uint32_t now = micros();
+    if (!m_started)
+    {
+      m_next_frame = now;
+      m_started = true;
+    }
+
+    // difference is wrap-safe as long as deadlines are less than 35 minutes apart
+    int32_t late = (int32_t)(now - m_next_frame);
+    if (late < 0)
+      return false;
+
+    // fell behind by more than one frame -> drop missed frames instead of rendering them back to back
+    if ((uint32_t)late >= m_frame_time)
+    {
+      uint32_t missed = late / m_frame_time;
+      m_stats.skipped += missed;
+      m_next_frame += missed * m_frame_time;
+      late -= missed * m_frame_time;
+    }
+
+    for (uint8_t i = 0; i < m_num_strips; i++)
+    {
+      m_strips[i]->update();
+    }
+
+    uint32_t render_time = micros() - now;
+    if (render_time > m_frame_time)
+      m_stats.overruns++;
+    if (render_time > m_stats.render_max)
+      m_stats.render_max = render_time;
+
+    if (m_stats.frames == 0 || (uint32_t)late < m_stats.jitter_min)
+      m_stats.jitter_min = late;
+    if ((uint32_t)late > m_stats.jitter_max)
+      m_stats.jitter_max = late;
+    m_stats.jitter_avg += ((int32_t)late - (int32_t)m_stats.jitter_avg) / 16;
+    m_stats.frames++;
+
+    m_next_frame += m_frame_time;
+    return true;
+  }
+
+  /**
+   * @returns time in us until the next frame is due, 0 if it is already due
+  */
+  uint32_t timeUntilNextFrame()
+  {
+    int32_t remaining = (int32_t)(m_next_frame - micros());
+    return !m_started || remaining < 0 ? 0 : remaining;
+  }
+
+  /**
+   * time until any strip needs a frame, the main loop may sleep until then
+   * @returns time in ms, rounded up to the next frame, LED_Strip::NEVER if all strips are static
+  */
+  uint32_t nextUpdateDue()
+  {
+    uint32_t due = LED_Strip::NEVER;
+    for (uint8_t i = 0; i < m_num_strips; i++)
+    {
+      due = min(due, m_strips[i]->nextUpdateDue());
+    }
+    if (due == LED_Strip::NEVER)
+      return due;
+    return max(due, (timeUntilNextFrame() + 999) / 1000);
+  }
+
+  inline const Stats &getStats()
+  {
+    return m_stats;
+  }
+
+  inline LED_Scheduler &resetStats()
+  {
+    m_stats = Stats();
+    return *this;
+  }
+};
+
+#endif //LED_SCHEDULER_H
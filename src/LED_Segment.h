@@ -0,0 +1,71 @@
+#ifndef LED_SEGMENT_H
+#define LED_SEGMENT_H
+
+#include <Adressable_LED_Strip.h>
+
+/**
+ * part of a physical strip acting as a strip of its own
+ * a segment has its own mode, brightness, color transitions and effects but writes into the output buffer of its parent
+ * once a strip has segments, updating the parent renders all segments and writes the hardware once per frame
+ * leds of the parent that are not covered by a segment keep their last color
+*/
+class LED_Segment : public Adressable_LED_Strip
+{
+protected:
+  LED_Strip &m_parent;
+
+  static uint16_t clampOffset(LED_Strip &parent, const uint16_t offset)
+  {
+    return min(offset, (uint16_t)(parent.m_num_leds - 1));
+  }
+
+  static uint16_t clampLength(LED_Strip &parent, const uint16_t offset, const uint16_t length)
+  {
+    return min(length, (uint16_t)(parent.m_num_leds - clampOffset(parent, offset)));
+  }
+
+public:
+  /**
+   * @param parent strip holding the output buffer
+   * @param offset index of first led in parent
+   * @param length number of leds
+   * @param reverse true if led 0 of the segment is the last led of its range in the parent
+  */
+  LED_Segment(LED_Strip &parent, const uint16_t offset, const uint16_t length, const bool reverse = false)
+      : Adressable_LED_Strip(parent.m_leds + clampOffset(parent, offset), clampLength(parent, offset, length)),
+        m_parent(parent)
+  {
+    m_reverse = reverse;
+
+    // append to segments of parent
+    LED_Strip **s = &parent.m_segments;
+    while (*s)
+      s = &(*s)->m_next_segment;
+    *s = this;
+  }
+
+  virtual ~LED_Segment()
+  {
+    // remove from segments of parent
+    for (LED_Strip **s = &m_parent.m_segments; *s; s = &(*s)->m_next_segment)
+    {
+      if (*s == this)
+      {
+        *s = m_next_segment;
+        break;
+      }
+    }
+  }
+
+  // output is written by the parent
+  virtual void show() override {}
+
+  // render only, call update() of the parent to write the hardware
+  virtual void update() override
+  {
+    if (render())
+      m_parent.m_segments_rendered = true;
+  }
+};
+
+#endif //LED_SEGMENT_H
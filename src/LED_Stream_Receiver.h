@@ -0,0 +1,292 @@
+#ifndef LED_STREAM_RECEIVER_H
+#define LED_STREAM_RECEIVER_H
+
+#include <Adressable_LED_Strip.h>
+
+/**
+ * receives pixel streams from a show controller via DDP or E1.31 (sACN)
+ * pixel payloads are copied straight into the raw buffer of the strip, only the packet header is buffered
+ * the transport is not part of this class:
+ * - poll(udp) reads from any object with the Arduino UDP interface (parsePacket(), read(buf, len))
+ * - handlePacket(data, len) parses a packet that has already been received
+ * a frame may span several packets, available() returns true once it is complete (DDP push flag,
+ * E1.31 sync packet or last universe of the strip) and the strip should be updated afterwards
+*/
+class LED_Stream_Receiver
+{
+public:
+  static const uint16_t DDP_PORT = 4048;
+  static const uint16_t E131_PORT = 5568;
+  static const uint8_t MAX_UNIVERSES = 12;       // sequence tracking for 2040 leds
+  static const uint8_t LEDS_PER_UNIVERSE = 170; // 510 of 512 dmx channels
+
+  struct Stats
+  {
+    uint32_t packets = 0; // packets received
+    uint32_t frames = 0;  // completed frames
+    uint32_t invalid = 0; // malformed or unknown packets
+    uint32_t dropped = 0; // packets missing according to sequence numbers
+    uint32_t late = 0;    // packets received out of order, they are discarded
+  };
+
+protected:
+  static const uint8_t DDP_HEADER = 10;
+  static const uint8_t DDP_TIMECODE = 0x10;
+  static const uint8_t DDP_QUERY = 0x02;
+  static const uint8_t DDP_REPLY = 0x04;
+  static const uint8_t DDP_PUSH = 0x01;
+
+  static const uint8_t E131_HEADER = 126;
+  static const uint8_t E131_SYNC_SIZE = 49;
+  static const uint8_t E131_PREVIEW = 0x80;
+  static const uint8_t E131_TERMINATED = 0x40;
+
+  Adressable_LED_Strip &m_strip;
+  uint16_t m_offset;   // first led written
+  uint16_t m_universe; // E1.31 universe mapped to m_offset
+
+  uint8_t m_ddp_seq = 0; // 0 -> no sequence received yet
+  uint8_t m_e131_seq[MAX_UNIVERSES];
+  uint16_t m_e131_seen = 0;   // bit per universe with valid m_e131_seq
+  uint16_t m_sync_address = 0; // sync universe announced by the last data packet
+
+  bool m_frame_ready = false;
+  Stats m_stats;
+
+  // sources for readRaw()
+  struct MemorySource
+  {
+    const uint8_t *p;
+    size_t n;
+
+    size_t read(uint8_t *dst, size_t len)
+    {
+      len = min(len, n);
+      memcpy(dst, p, len);
+      p += len;
+      n -= len;
+      return len;
+    }
+  };
+
+  template <class UDP>
+  struct UdpSource
+  {
+    UDP &udp;
+
+    size_t read(uint8_t *dst, size_t len)
+    {
+      int r = udp.read(dst, len);
+      return r < 0 ? 0 : r;
+    }
+  };
+
+  static inline uint16_t be16(const uint8_t *p)
+  {
+    return ((uint16_t)p[0] << 8) | p[1];
+  }
+
+  static inline uint32_t be32(const uint8_t *p)
+  {
+    return ((uint32_t)be16(p) << 16) | be16(p + 2);
+  }
+
+  void frameComplete()
+  {
+    m_frame_ready = true;
+    m_stats.frames++;
+  }
+
+  /**
+   * parse one packet of len bytes, header bytes are read into a stack buffer, pixels directly into the strip
+   * @returns true if the packet has been accepted
+  */
+  template <class SOURCE>
+  bool receive(SOURCE &src, const size_t len)
+  {
+    m_stats.packets++;
+
+    uint8_t h[E131_HEADER];
+    if (len < DDP_HEADER || src.read(h, DDP_HEADER) != DDP_HEADER)
+    {
+      m_stats.invalid++;
+      return false;
+    }
+
+    if (h[0] == 0x00 && h[1] == 0x10) // E1.31 preamble size
+      return receiveE131(src, len, h);
+    if ((h[0] & 0xC0) == 0x40) // DDP version 1
+      return receiveDDP(src, len, h);
+
+    m_stats.invalid++;
+    return false;
+  }
+
+  template <class SOURCE>
+  bool receiveDDP(SOURCE &src, const size_t len, uint8_t *h)
+  {
+    const uint8_t flags = h[0];
+    if (flags & (DDP_QUERY | DDP_REPLY))
+      return false; // no display data
+
+    size_t header = DDP_HEADER;
+    if (flags & DDP_TIMECODE)
+    {
+      header += 4;
+      if (len < header || src.read(h + DDP_HEADER, 4) != 4)
+      {
+        m_stats.invalid++;
+        return false;
+      }
+    }
+
+    const uint32_t offset = be32(h + 4); // in bytes
+    if (h[3] > 1 || offset % 3 != 0)
+    { // only the default output device with whole leds
+      m_stats.invalid++;
+      return false;
+    }
+
+    const uint8_t seq = h[1] & 0x0F; // 0 -> sequence not used
+    if (seq != 0 && m_ddp_seq != 0)
+    {
+      const uint8_t expected = m_ddp_seq % 15 + 1; // 1..15
+      const uint8_t gap = (seq + 15 - expected) % 15;
+      if (gap > 7)
+      {
+        m_stats.late++;
+        return false;
+      }
+      m_stats.dropped += gap;
+    }
+    if (seq != 0)
+      m_ddp_seq = seq;
+
+    const size_t length = min((size_t)be16(h + 8), len - header);
+    if (offset / 3 < 0x10000u - m_offset)
+      m_strip.readRaw(m_offset + offset / 3, length / 3, src);
+
+    if (flags & DDP_PUSH)
+      frameComplete();
+    return true;
+  }
+
+  template <class SOURCE>
+  bool receiveE131(SOURCE &src, const size_t len, uint8_t *h)
+  {
+    static const uint8_t ACN_ID[12] = {'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0, 0, 0};
+
+    if (len < E131_SYNC_SIZE || src.read(h + DDP_HEADER, E131_SYNC_SIZE - DDP_HEADER) != E131_SYNC_SIZE - DDP_HEADER || memcmp(h + 4, ACN_ID, 12) != 0)
+    {
+      m_stats.invalid++;
+      return false;
+    }
+
+    const uint32_t root_vector = be32(h + 18);
+    if (root_vector == 0x08 && be32(h + 40) == 0x01)
+    { // synchronization packet
+      if (m_sync_address != 0 && be16(h + 45) == m_sync_address)
+        frameComplete();
+      return true;
+    }
+
+    if (root_vector != 0x04 || len < E131_HEADER || src.read(h + E131_SYNC_SIZE, E131_HEADER - E131_SYNC_SIZE) != E131_HEADER - E131_SYNC_SIZE || be32(h + 40) != 0x02 || h[117] != 0x02)
+    {
+      m_stats.invalid++;
+      return false;
+    }
+
+    const uint8_t options = h[112];
+    const uint16_t universe = be16(h + 113);
+    if (h[125] != 0 || (options & (E131_PREVIEW | E131_TERMINATED)) || universe < m_universe || universe - m_universe >= MAX_UNIVERSES)
+      return false; // not for this strip or no dimmer data
+
+    const uint8_t u = universe - m_universe;
+    const uint8_t seq = h[111];
+    if (m_e131_seen & (1 << u))
+    { // out of order as defined by E1.31 6.7.2
+      const int8_t diff = seq - m_e131_seq[u];
+      if (diff <= 0 && diff > -20)
+      {
+        m_stats.late++;
+        return false;
+      }
+      if (diff > 1)
+        m_stats.dropped += diff - 1;
+    }
+    m_e131_seq[u] = seq;
+    m_e131_seen |= 1 << u;
+
+    const uint16_t count = be16(h + 123); // including start code
+    const size_t channels = min(min((size_t)(count > 0 ? count - 1 : 0), len - E131_HEADER), (size_t)LEDS_PER_UNIVERSE * 3);
+    m_strip.readRaw(m_offset + u * LEDS_PER_UNIVERSE, channels / 3, src);
+
+    m_sync_address = be16(h + 109);
+    if (m_sync_address == 0 && universe == getLastUniverse())
+      frameComplete();
+    return true;
+  }
+
+public:
+  /**
+   * @param offset first led written by the stream
+   * @param universe E1.31 universe of the led at offset, following universes continue the strip
+  */
+  LED_Stream_Receiver(Adressable_LED_Strip &strip, const uint16_t offset = 0, const uint16_t universe = 1)
+      : m_strip(strip), m_offset(offset), m_universe(universe) {}
+
+  /**
+   * read one pending packet from an Arduino style UDP object, call it until it returns false
+   * @returns true if a packet has been processed
+  */
+  template <class UDP>
+  bool poll(UDP &udp)
+  {
+    int size = udp.parsePacket();
+    if (size <= 0)
+      return false;
+
+    UdpSource<UDP> src = {udp};
+    receive(src, size);
+    return true;
+  }
+
+  /**
+   * parse a received DDP or E1.31 packet
+   * @returns true if the packet has been accepted
+  */
+  bool handlePacket(const uint8_t *data, const size_t len)
+  {
+    MemorySource src = {data, len};
+    return receive(src, len);
+  }
+
+  /**
+   * @returns true once after a frame has been completed
+  */
+  bool available()
+  {
+    bool ready = m_frame_ready;
+    m_frame_ready = false;
+    return ready;
+  }
+
+  // last universe covering the strip
+  inline uint16_t getLastUniverse()
+  {
+    uint16_t n = m_strip.getNumLeds() > m_offset ? m_strip.getNumLeds() - m_offset : 1;
+    return m_universe + (n - 1) / LEDS_PER_UNIVERSE;
+  }
+
+  inline const Stats &getStats()
+  {
+    return m_stats;
+  }
+
+  inline void resetStats()
+  {
+    m_stats = Stats();
+  }
+};
+
+#endif //LED_STREAM_RECEIVER_H
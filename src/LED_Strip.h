@@ -5,21 +5,104 @@
 #define FASTLED_ALLOW_INTERRUPTS 0
 #include <FastLED.h>
 
-#include <FilterLinear.h>
 #include <CRGB_d.h>
+#include <LED_Crossfade.h>
+#include <LED_Transition.h>
+#include <LED_Strip_Stats.h>
 
 #include "led_helper.h"
+#include "led_kernels.h"
+#include "led_rle.h"
+
+class LED_Segment;
+
+/**
+ * output order of leds that are not wired in their logical order, e.g. a matrix
+ * logical leds are numbered row by row, the logical led at sx, sy is shown at
+ * x = (sx - origin_x) % width and y = (sy - origin_y) % height, so moving the origin scrolls in 2D
+ * output[y * width + x] is the output led showing pixel x, y, leds from size on are shown in logical order
+*/
+struct LED_Pixel_Map
+{
+  const uint16_t *output;
+  uint16_t size;
+  uint8_t width;
+  uint8_t height;
+  uint8_t origin_x;
+  uint8_t origin_y;
+
+  /**
+   * call f(i, o) for logical leds first to last with o the output showing led i
+   * walks the table row by row so no led needs a division
+  */
+  template <class F>
+  void forEach(uint16_t first, const uint16_t last, F f) const
+  {
+    if (first < size)
+    {
+      uint16_t sy = first / width;
+      uint16_t sx = first - sy * width;
+      uint16_t x = sx >= origin_x ? sx - origin_x : sx + width - origin_x;
+      uint16_t y = sy >= origin_y ? sy - origin_y : sy + height - origin_y;
+      const uint16_t *row = &output[y * width];
+      const uint16_t end = min(last, (uint16_t)(size - 1));
+      while (first <= end)
+      { // leds up to the end of the row or the column wrapped by the origin are contiguous in the table
+        uint16_t run = min((uint16_t)(end - first + 1), (uint16_t)(width - max(sx, x)));
+        for (uint16_t k = 0; k < run; k++)
+          f(first + k, row[x + k]);
+        first += run;
+        sx += run;
+        x += run;
+        if (x == width)
+          x = 0;
+        if (sx == width)
+        { // next row starts at the column showing sx == 0
+          sx = 0;
+          x = origin_x ? width - origin_x : 0;
+          if (++y == height)
+            y = 0;
+          row = &output[y * width];
+        }
+      }
+    }
+    for (; first <= last; first++)
+      f(first, first);
+  }
+};
+
+/**
+ * changes queued for a strip, e.g. by another thread or a network callback
+ * the strip applies them at the start of each frame so a frame never shows half of a change, see LED_Command_Queue
+*/
+class LED_Command_Buffer
+{
+public:
+  virtual ~LED_Command_Buffer() {}
+
+  // apply all queued commands, called by the strip at the start of updateLeds()
+  virtual void apply() = 0;
+
+  // @returns true if commands are waiting to be applied
+  virtual bool pending() = 0;
+};
 
 class LED_Strip
 {
+  friend class LED_Segment;
 
 public:
   enum MODE
   {
     MANY,
-    SINGLE
+    SINGLE,
+    PALETTE // one palette index per led
   };
 
+  static const uint32_t NEVER = 0xFFFFFFFF; // see nextUpdateDue()
+
+  static const uint8_t STATE_VERSION = 1; // format of saveState()
+
 protected:
   MODE m_led_mode = MODE::SINGLE; // treat leds as one single color or individually
 
@@ -28,74 +111,471 @@ protected:
   bool m_power = 0;                // only necessary for setting power
   uint8_t m_brightness_target = 0; // save state of brightness
 
-  uint16_t m_transition_time = 0; // for determining if leds should be updated
-  unsigned long m_last_update = 0;
+  uint16_t m_dirty_min = 0; // range of raw leds changed since last render, empty if min > max
+  uint16_t m_dirty_max = 0;
+  MODE m_rendered_mode = MODE::SINGLE; // mode used for last render, switching modes requires a full render
+  bool m_leds_changed = false;         // output buffer changed during last render
+  bool m_settled = false;              // brightness and color transitions reached their targets
 
   CRGB m_color_correction = 0xFFFFFF; // apply color correction to leds if not every color has equal brightness
 
-  CRGB *m_leds;     // store led color in array mostly necessary for fastled
-  CRGB *m_leds_raw; //unscaled version
+  CRGB *m_leds;                // store led color in array mostly necessary for fastled
+  bool m_owns_leds = true;     // false if m_leds is part of another strip
+  bool m_reverse = false;      // write leds to m_leds in reverse order
+  CRGB *m_leds_raw = nullptr;  // unscaled version, only allocated once leds are addressed individually
+  CRGB m_single_color = 0;     // unscaled color of all leds while there is no individual data
+  uint16_t m_raw_head = 0; // index in m_leds_raw of the first led, allows scrolling without moving data
+
+  uint8_t *m_indices = nullptr;        // palette index per led in palette mode, ring buffer like m_leds_raw
+  CRGB *m_palette = nullptr;           // unscaled palette of 16 or 256 colors
+  CRGB *m_palette_scaled = nullptr;    // palette scaled with brightness and correction, rebuilt only if necessary
+  uint16_t *m_palette_count = nullptr; // number of leds using each palette entry, for the power estimate
+  uint16_t m_palette_size = 0;
+  bool m_palette_changed = false;      // palette colors changed since last render
+
+  ScaledColorTable m_scale_table; // per frame lookup table for scaling many leds
+  LED_Crossfade m_crossfade;      // smooth transition between frames in many mode
+
+  DitheredColorTable *m_dither_table = nullptr; // 16 bit scaling, only allocated if dithering is enabled
+  uint8_t *m_dither_err = nullptr;              // fraction carried to next frame per led and channel
+
+  LED_Transition<4> m_transition; // smooth transition of brightness and color, channels see TRANSITION_*
+
+  uint16_t m_max_milliamps = 0;        // power budget, 0 -> unlimited
+  uint8_t m_milliamps_per_channel = 20; // current of one channel at full output
+  uint32_t m_power_sum[3] = {0, 0, 0};  // sum of linearized raw channels, only maintained while a budget is set
+  uint32_t m_milliamps = 0;             // estimated current of last render
+  uint8_t m_rendered_bri = 0;           // brightness used for last render after power limiting
+
+  const LED_Pixel_Map *m_pixel_map = nullptr; // output order of leds, nullptr -> outputs follow the logical order
+
+  LED_Command_Buffer *m_commands = nullptr; // queued changes applied at the start of each frame
+
+  LED_Strip *m_segments = nullptr;     // first segment sharing m_leds, segments replace rendering of this strip
+  LED_Strip *m_next_segment = nullptr; // next segment of the same parent
+  bool m_segments_rendered = false;    // a segment rendered on its own since the last render of this strip
+
+#if LED_STRIP_STATS
+  LED_Strip_Stats m_stats; // performance counters, compiled out if disabled
+#endif
+
+  // channels of m_transition
+  static const uint8_t TRANSITION_BRI = 0;
+  static const uint8_t TRANSITION_R = 1;
+  static const uint8_t TRANSITION_G = 2;
+  static const uint8_t TRANSITION_B = 3;
+
+  /**
+   * mark range of raw leds as changed so it is recalculated during next render
+  */
+  inline void markDirty(const uint16_t first, const uint16_t last)
+  {
+    if (first < m_dirty_min)
+      m_dirty_min = first;
+    if (last > m_dirty_max)
+      m_dirty_max = last;
+  }
+
+  inline void markDirty(const uint16_t i)
+  {
+    markDirty(i, i);
+  }
+
+  inline void markAllDirty()
+  {
+    markDirty(0, m_num_leds - 1);
+  }
+
+  inline bool isDirty()
+  {
+    return m_dirty_min <= m_dirty_max;
+  }
+
+  /**
+   * @returns index in m_leds_raw of led i
+  */
+  inline uint16_t rawIndex(const uint16_t i)
+  {
+    uint32_t p = (uint32_t)i + m_raw_head;
+    return p >= m_num_leds ? p - m_num_leds : p;
+  }
+
+  /**
+   * get raw buffer, allocate it on first use
+   * strips only used with one color never need individual raw data
+  */
+  CRGB *rawLeds()
+  {
+    if (!m_leds_raw)
+    {
+      m_leds_raw = new CRGB[m_num_leds];
+      if (m_led_mode == MODE::PALETTE && m_indices)
+        expandPalette();
+      else
+        fillRaw(m_single_color);
+    }
+    return m_leds_raw;
+  }
+
+  void fillRaw(const CRGB &c)
+  {
+    for (uint16_t i = 0; i < m_num_leds; i++)
+    {
+      m_leds_raw[i] = c;
+    }
+    m_raw_head = 0;
+    powerRecalc();
+  }
+
+  /**
+   * write the palette color of every led to the raw buffer, allocates it on first use
+   * raw and index buffer share m_raw_head so the ring order is kept
+  */
+  void expandPalette()
+  {
+    if (!m_leds_raw)
+      m_leds_raw = new CRGB[m_num_leds];
+    for (uint16_t i = 0; i < m_num_leds; i++)
+    {
+      m_leds_raw[i] = m_palette[m_indices[i]];
+    }
+    powerRecalc();
+  }
+
+  /**
+   * allocate palette with 16 or 256 entries, existing colors are kept
+  */
+  void allocPalette(const uint16_t size)
+  {
+    if (size == m_palette_size)
+      return;
+
+    CRGB *palette = new CRGB[size];
+    uint16_t *count = new uint16_t[size];
+    for (uint16_t k = 0; k < size; k++)
+    {
+      palette[k] = k < m_palette_size ? m_palette[k] : CRGB(0);
+      count[k] = k < m_palette_size ? m_palette_count[k] : 0;
+    }
+    // indices beyond a smaller palette wrap around
+    for (uint16_t k = size; k < m_palette_size; k++)
+    {
+      count[k & (size - 1)] += m_palette_count[k];
+    }
+    if (m_indices && size < m_palette_size)
+    {
+      for (uint16_t i = 0; i < m_num_leds; i++)
+        m_indices[i] &= size - 1;
+    }
+
+    delete[] m_palette;
+    delete[] m_palette_scaled;
+    delete[] m_palette_count;
+    m_palette = palette;
+    m_palette_scaled = new CRGB[size];
+    m_palette_count = count;
+    m_palette_size = size;
+    m_palette_changed = true;
+  }
 
-  FilterLinear m_filter_bri; // filters for smooth transition
-  FilterLinear m_filter_color_r;
-  FilterLinear m_filter_color_g;
-  FilterLinear m_filter_color_b;
+  /**
+   * set all palette indices to k, allocates index buffer on first use
+  */
+  void fillIndices(const uint8_t k)
+  {
+    if (!m_palette)
+      allocPalette(16);
+    if (!m_indices)
+      m_indices = new uint8_t[m_num_leds];
+
+    uint8_t index = k & (m_palette_size - 1);
+    memset(m_indices, index, m_num_leds);
+    memset(m_palette_count, 0, m_palette_size * sizeof(uint16_t));
+    m_palette_count[index] = m_num_leds;
+    m_raw_head = 0;
+  }
+
+  /**
+   * add or remove leds first to last from the power sums
+   * called around every write to the raw buffer so the estimate never needs a full pass
+  */
+  void powerSum(const uint16_t first, const uint16_t last, const bool add)
+  {
+    if (!m_max_milliamps || !m_leds_raw)
+      return;
+    uint16_t p = rawIndex(first);
+    for (uint16_t i = first; i <= last; i++)
+    {
+      const CRGB &c = m_leds_raw[p];
+      uint8_t lin[3] = {ledLinBrightness(c.r), ledLinBrightness(c.g), ledLinBrightness(c.b)};
+      for (uint8_t ch = 0; ch < 3; ch++)
+      {
+        if (add)
+          m_power_sum[ch] += lin[ch];
+        else
+          m_power_sum[ch] -= lin[ch];
+      }
+      if (++p == m_num_leds)
+        p = 0;
+    }
+  }
+
+  // rebuild power sums from the entire raw buffer
+  void powerRecalc()
+  {
+    m_power_sum[0] = m_power_sum[1] = m_power_sum[2] = 0;
+    powerSum(0, m_num_leds - 1, true);
+  }
+
+  /**
+   * estimate current and reduce brightness so it stays within the power budget
+   * @param bri brightness from the brightness filter
+   * @param c color of all leds if they are not addressed individually
+   * @returns brightness to render with
+  */
+  uint8_t limitBrightness(uint8_t bri, const CRGB &c)
+  {
+    // sum of linearized channels weighted with color correction
+    uint64_t weighted = 0;
+    if (m_led_mode == MODE::PALETTE)
+    { // palette entries weighted with the number of leds using them
+      for (uint16_t k = 0; k < m_palette_size; k++)
+      {
+        const CRGB &p = m_palette[k];
+        if (m_palette_count[k])
+          weighted += (uint64_t)m_palette_count[k] * ((uint32_t)ledLinBrightness(p.r) * m_color_correction.r + (uint32_t)ledLinBrightness(p.g) * m_color_correction.g + (uint32_t)ledLinBrightness(p.b) * m_color_correction.b);
+      }
+    }
+    else if (m_led_mode == MODE::SINGLE || !m_leds_raw)
+      weighted = (uint64_t)m_num_leds * ((uint32_t)ledLinBrightness(c.r) * m_color_correction.r + (uint32_t)ledLinBrightness(c.g) * m_color_correction.g + (uint32_t)ledLinBrightness(c.b) * m_color_correction.b);
+    else
+      weighted = (uint64_t)m_power_sum[0] * m_color_correction.r + (uint64_t)m_power_sum[1] * m_color_correction.g + (uint64_t)m_power_sum[2] * m_color_correction.b;
+    weighted *= m_milliamps_per_channel;
+
+    // output channel ~ lin * bri * correction / 255^2, full output draws m_milliamps_per_channel
+    const uint32_t full = 255UL * 255 * 255;
+    if (weighted * bri > (uint64_t)m_max_milliamps * full)
+      bri = (uint64_t)m_max_milliamps * full / weighted;
+
+    m_milliamps = weighted * bri / full;
+    return bri;
+  }
 
   /**
    * internal method to update led calculation
    * this function must be called at the beginning of every LED_Strip update implementation
+   * only leds whose raw color, brightness or correction changed are recalculated
   */
   LED_Strip &updateLeds()
   {
-    // update brightness filter
-    m_filter_bri.setTarget(m_power ? m_brightness_target : 0);
-    m_filter_bri.update();
-    // calculate smooth color transition and apply to all leds
-    // update each color separately
-    m_filter_color_r.update();
-    m_filter_color_g.update();
-    m_filter_color_b.update();
+#if LED_STRIP_STATS
+    uint32_t stats_start = micros();
+#endif
 
-    // single mode -> the entire strip acts as one led
-    if (m_led_mode == MODE::SINGLE)
+    // changes from other threads are applied at once, before anything is rendered
+    if (m_commands)
+      m_commands->apply();
+
+    // advance brightness and color transition, clock is read once per frame
+    m_transition.setTarget(TRANSITION_BRI, m_power ? m_brightness_target : 0);
+    bool transition_changed = m_transition.update(millis());
+    m_settled = m_transition.settled();
+
+    // nothing changed since last render -> skip all work
+    if (!transition_changed && !isDirty() && m_led_mode == m_rendered_mode && !m_dither_table && !m_crossfade.isActive())
+    {
+      m_leds_changed = false;
+#if LED_STRIP_STATS
+      m_stats.frames_skipped++;
+      m_stats.render_time.add(micros() - stats_start);
+#endif
+      return *this;
+    }
+
+    uint8_t bri = m_transition.getValue(TRANSITION_BRI);
+    // create color object from animated r g b values
+    CRGB c = CRGB(m_transition.getValue(TRANSITION_R), m_transition.getValue(TRANSITION_G), m_transition.getValue(TRANSITION_B));
+
+    if (m_max_milliamps)
+      bri = limitBrightness(bri, m_led_mode == MODE::SINGLE ? c : m_single_color);
+    m_rendered_bri = bri;
+
+    // a mode switch invalidates the entire output
+    if (m_led_mode != m_rendered_mode)
+    {
+      markAllDirty();
+      m_rendered_mode = m_led_mode;
+    }
+    m_leds_changed = false;
+
+    // a crossfade advances in every frame, only many mode with a raw frame blends the leds
+    bool fading = m_crossfade.update() && m_led_mode == MODE::MANY && m_leds_raw;
+
+    // temporal dithering -> output differs in every frame, render all leds with 16 bit precision
+    if (m_dither_table)
     {
-      // create color object from animated r g b values
-      CRGB c = CRGB(m_filter_color_r.getValue(), m_filter_color_g.getValue(), m_filter_color_b.getValue());
+      if (m_led_mode == MODE::SINGLE)
+        m_single_color = c;
+
+      m_dither_table->update(bri, m_color_correction);
+      renderDithered(fading);
+
+      m_leds_changed = true;
+#if LED_STRIP_STATS
+      m_stats.pixels_recomputed += m_num_leds;
+#endif
+    }
+    // palette mode -> scale palette once, leds only look up their entry
+    else if (m_led_mode == MODE::PALETTE)
+    {
+      if (m_scale_table.update(bri, m_color_correction) || m_palette_changed)
+      {
+        for (uint16_t k = 0; k < m_palette_size; k++)
+        {
+          m_palette_scaled[k] = m_scale_table.scale(m_palette[k]);
+        }
+        m_palette_changed = false;
+        markAllDirty();
+      }
+
+      renderDirty([this](const uint16_t p) { return m_palette_scaled[m_indices[p]]; });
+    }
+    // single mode or many mode without individual data -> the entire strip acts as one led
+    else if (m_led_mode == MODE::SINGLE || !m_leds_raw)
+    {
+      // keep raw color only once, it is copied to the raw buffer when switching to many mode
+      if (m_led_mode == MODE::SINGLE)
+        m_single_color = c;
 
       // calculate adjusted version of color so perceived brightness is linear
-      CRGB scaled_color = scaledColor(c, m_filter_bri.getValue(), m_color_correction);
+      CRGB scaled_color = scaledColor(m_single_color, bri, m_color_correction);
 
-      for (uint16_t i = 0; i < m_num_leds; i++)
+      // only write leds if the color visibly changed
+      if (isDirty() || scaled_color != m_leds[0])
       {
         // scaled color to output
-        m_leds[i] = scaled_color;
-        // store raw color in raw_leds array to allow for modification in individual mode
-        m_leds_raw[i] = c;
+        bulkFill(m_leds, m_num_leds, scaled_color);
+        m_leds_changed = true;
+#if LED_STRIP_STATS
+        m_stats.pixels_recomputed += m_num_leds;
+#endif
       }
     }
     // multi mode -> each led is separately addressable
     else if (m_led_mode == MODE::MANY)
     {
-      // copy from raw data
-      for (uint16_t i = 0; i < m_num_leds; i++)
+      // brightness and correction are constant during one frame -> rebuild table only if they change
+      if (m_scale_table.update(bri, m_color_correction))
+        markAllDirty();
+
+      // a running crossfade changes every led in every frame
+      if (fading)
+        markAllDirty();
+
+      // copy from raw data, limited to changed leds
+      if (fading) // blend from start frame to raw data and scale result
+        renderDirty([this](const uint16_t p) { return m_scale_table.scale(m_crossfade.blend(p, m_leds_raw[p])); });
+      else // scale color to right brightness
+        renderDirty([this](const uint16_t p) { return m_scale_table.scale(m_leds_raw[p]); });
+    }
+
+    // everything is rendered -> reset dirty range to empty
+    m_dirty_min = m_num_leds;
+    m_dirty_max = 0;
+
+#if LED_STRIP_STATS
+    if (m_leds_changed)
+      m_stats.frames_rendered++;
+    else
+      m_stats.frames_skipped++;
+    m_stats.render_time.add(micros() - stats_start);
+#endif
+
+    return *this;
+  }
+
+  /**
+   * write changed leds to the output buffer
+   * @param color function object returning the output color of raw index p
+  */
+  template <class COLOR>
+  void renderDirty(COLOR color)
+  {
+    if (!isDirty())
+      return;
+
+    if (m_pixel_map)
+    { // output order differs from logical order -> write changed leds to their outputs
+      m_pixel_map->forEach(m_dirty_min, m_dirty_max, [this, &color](const uint16_t i, const uint16_t o) {
+        m_leds[o] = color(rawIndex(i));
+      });
+    }
+    else
+    {
+      // raw data is a ring buffer starting at m_raw_head
+      uint16_t p = rawIndex(m_dirty_min);
+      // output may be written back to front
+      CRGB *out = m_reverse ? &m_leds[m_num_leds - 1 - m_dirty_min] : &m_leds[m_dirty_min];
+      int8_t step = m_reverse ? -1 : 1;
+      for (uint16_t i = m_dirty_min; i <= m_dirty_max; i++, out += step)
       {
-        // scale color to right brightness
-        m_leds[i] = scaledColor(m_leds_raw[i], m_filter_bri.getValue(), m_color_correction);
+        *out = color(p);
+        if (++p == m_num_leds)
+          p = 0;
       }
     }
 
-    return *this;
+    m_leds_changed = true;
+#if LED_STRIP_STATS
+    m_stats.pixels_recomputed += m_dirty_max - m_dirty_min + 1;
+#endif
+  }
+
+  /**
+   * render all leds using the dither table
+   * @param fading true if a crossfade is running
+  */
+  void renderDithered(const bool fading)
+  {
+    bool palette = m_led_mode == MODE::PALETTE;
+    bool uniform = m_led_mode == MODE::SINGLE || (!palette && !m_leds_raw);
+    auto dither = [&](const uint16_t p, uint8_t *err) -> CRGB {
+      if (uniform)
+        return m_dither_table->dither(m_single_color, err);
+      if (palette)
+        return m_dither_table->dither(m_palette[m_indices[p]], err);
+      if (fading)
+        return m_dither_table->dither(m_crossfade.blend(p, m_leds_raw[p]), err);
+      return m_dither_table->dither(m_leds_raw[p], err);
+    };
+
+    if (m_pixel_map)
+    { // output order differs from logical order, the fraction carried is kept per output
+      m_pixel_map->forEach(0, m_num_leds - 1, [&](const uint16_t i, const uint16_t o) {
+        m_leds[o] = dither(rawIndex(i), &m_dither_err[o * 3]);
+      });
+      return;
+    }
+
+    uint8_t *err = m_dither_err;
+    uint16_t p = m_raw_head;
+    CRGB *out = m_reverse ? &m_leds[m_num_leds - 1] : m_leds;
+    int8_t step = m_reverse ? -1 : 1;
+    for (uint16_t i = 0; i < m_num_leds; i++, out += step, err += 3)
+    {
+      *out = dither(p, err);
+      if (++p == m_num_leds)
+        p = 0;
+    }
   }
 
   /**
    * determine if leds should be updated
-   * @returns true if update necessary else false
+   * @returns true if the last call of updateLeds() changed the output else false
   */
   bool isUpdateNecessary()
   {
-    if (millis() > m_last_update + m_transition_time)
-      return false;
-    return true;
+    return m_leds_changed;
   }
 
 public:
@@ -105,65 +585,212 @@ public:
     m_led_mode = m_num_leds == 1 ? MODE::SINGLE : MODE::MANY;
 
     m_leds = new CRGB[m_num_leds];
-    m_leds_raw = new CRGB[m_num_leds];
+
+    markAllDirty();
   }
 
-  ~LED_Strip()
+  /**
+   * strip writing to an existing output buffer instead of allocating its own, used for segments
+  */
+  LED_Strip(CRGB *leds, const unsigned int p_nleds)
   {
-    delete[] m_leds;
+    m_num_leds = max(1u, p_nleds);
+    m_led_mode = m_num_leds == 1 ? MODE::SINGLE : MODE::MANY;
+
+    m_leds = leds;
+    m_owns_leds = false;
+
+    markAllDirty();
+  }
+
+  virtual ~LED_Strip()
+  {
+    if (m_owns_leds)
+      delete[] m_leds;
     delete[] m_leds_raw;
+    delete[] m_indices;
+    delete[] m_palette;
+    delete[] m_palette_scaled;
+    delete[] m_palette_count;
+    delete m_dither_table;
+    delete[] m_dither_err;
   }
 
   LED_Strip &init(const CRGB &init_color, const uint8_t init_bri, const uint16_t transition_time)
   {
-    m_transition_time = transition_time;
-
     m_power = init_bri > 0 ? 1 : 0;
-    m_filter_bri.init(init_bri, transition_time);
+    uint8_t values[4] = {init_bri, init_color.r, init_color.g, init_color.b};
+    m_transition.init(values, transition_time);
 
-    m_filter_color_r.init(init_color.r, transition_time);
-    m_filter_color_g.init(init_color.g, transition_time);
-    m_filter_color_b.init(init_color.b, transition_time);
+    m_single_color = init_color;
 
     for (uint16_t i = 0; i < m_num_leds; i++)
     {
       m_leds[i] = init_color;
-      m_leds_raw[i] = init_color;
     }
+    if (m_leds_raw)
+      fillRaw(init_color);
+    if (m_led_mode == MODE::PALETTE)
+      fillIndices(0);
+    markAllDirty();
+    return *this;
+  }
+
+  /**
+   * render leds in a different output order, the map has to stay valid while it is set
+   * reverse is ignored while a map is set
+   * @param map nullptr restores the logical order
+  */
+  LED_Strip &setPixelMap(const LED_Pixel_Map *map)
+  {
+    m_pixel_map = map;
+    markAllDirty();
+    return *this;
+  }
+
+  /**
+   * apply commands of buffer at the start of each frame, the buffer has to stay valid while it is set
+   * @param commands nullptr removes the buffer
+  */
+  inline LED_Strip &setCommandBuffer(LED_Command_Buffer *commands)
+  {
+    m_commands = commands;
     return *this;
   }
 
   LED_Strip &forceUpdate()
   {
-    m_last_update = millis();
+    markAllDirty();
     return *this;
   }
 
   LED_Strip &fadeall(const uint8_t amount = 253)
   {
-    m_last_update = millis();
-    for (int i = 0; i < m_num_leds; i++)
+    if (m_led_mode == MODE::SINGLE)
+      return *this; // single color is controlled by color filters only
+
+    markAllDirty();
+    if (m_led_mode == MODE::PALETTE)
+    { // fading the palette fades all leds
+      bulkScale8((uint8_t *)m_palette, m_palette_size * 3, amount);
+      m_palette_changed = true;
+      return *this;
+    }
+    bulkScale8((uint8_t *)rawLeds(), m_num_leds * 3, amount);
+    powerRecalc();
+    return *this;
+  }
+
+  /**
+   * move all leds by n positions without copying raw data
+   * positive values move towards the end of the strip, leds shifted out at one end reappear at the other
+  */
+  LED_Strip &scroll(const int16_t n)
+  {
+    if (!m_leds_raw && !m_indices)
+      return *this; // all leds have the same color
+
+    int32_t head = ((int32_t)m_raw_head - n) % m_num_leds;
+    m_raw_head = head < 0 ? head + m_num_leds : head;
+    markAllDirty();
+    return *this;
+  }
+
+  /**
+   * enable temporal dithering
+   * leds are scaled with 16 bit precision and the fraction lost in the 8 bit output is carried to the next frame
+   * dim colors get smoother but the strip has to be rendered and shown in every frame
+  */
+  LED_Strip &setDither(const bool enable)
+  {
+    if (enable && !m_dither_table)
+    {
+      m_dither_table = new DitheredColorTable();
+      m_dither_err = new uint8_t[m_num_leds * 3];
+      for (uint16_t i = 0; i < m_num_leds * 3; i++)
+      {
+        m_dither_err[i] = i * 97; // spread start values so neighbouring leds do not step in sync
+      }
+    }
+    else if (!enable && m_dither_table)
     {
-      m_leds_raw[i].nscale8(amount);
+      delete m_dither_table;
+      delete[] m_dither_err;
+      m_dither_table = nullptr;
+      m_dither_err = nullptr;
     }
+    markAllDirty();
     return *this;
   }
 
+  inline bool getDither()
+  {
+    return m_dither_table;
+  }
+
+  /**
+   * limit the estimated current by reducing the brightness of the output
+   * the estimate is kept up to date with every write to the raw buffer, segments need their own budget
+   * @param milliamps power budget, 0 disables the limiter
+   * @param milliamps_per_channel current of one channel at full output, typically 20 mA for WS2812
+  */
+  LED_Strip &setMaxMilliamps(const uint16_t milliamps, const uint8_t milliamps_per_channel = 20)
+  {
+    m_max_milliamps = milliamps;
+    m_milliamps_per_channel = milliamps_per_channel;
+    markAllDirty();
+    m_milliamps = 0;
+    powerRecalc();
+    return *this;
+  }
+
+  inline uint16_t getMaxMilliamps()
+  {
+    return m_max_milliamps;
+  }
+
+  /**
+   * @returns estimated current of the last render in mA, 0 if no power budget is set
+  */
+  inline uint32_t getEstimatedMilliamps()
+  {
+    return m_milliamps;
+  }
+
   inline LED_Strip &setColorCorrection(const CRGB &color_correction)
   {
     m_color_correction = color_correction;
+    markAllDirty();
     return *this;
   }
 
-  inline uint8_t getNumLeds()
+  inline uint16_t getNumLeds()
   {
     return m_num_leds;
   }
 
-  inline LED_Strip &setBrightness(const uint8_t b)
+  /**
+   * @param transition_time duration of brightness and color transitions in ms
+  */
+  inline LED_Strip &setTransitionTime(const uint16_t transition_time)
   {
-    m_last_update = millis();
+    m_transition.setDuration(transition_time);
+    return *this;
+  }
+
+  inline uint16_t getTransitionTime()
+  {
+    return m_transition.getDuration();
+  }
+
+  inline LED_Strip &setTransitionEasing(const LED_Transition<4>::EASING easing)
+  {
+    m_transition.setEasing(easing);
+    return *this;
+  }
 
+  inline LED_Strip &setBrightness(const uint8_t b)
+  {
     m_brightness_target = b;
 
     return *this;
@@ -171,13 +798,11 @@ public:
 
   inline uint8_t getBrightness()
   {
-    return m_filter_bri.getValue();
+    return m_transition.getValue(TRANSITION_BRI);
   }
 
   inline LED_Strip &setPower(const bool s)
   {
-    m_last_update = millis();
-
     m_power = s;
 
     return *this;
@@ -190,13 +815,11 @@ public:
 
   LED_Strip &setColor(const CRGB &c)
   {
-    m_last_update = millis();
-
-    m_led_mode = MODE::SINGLE; //set to single mode so all leds are used as one
+    setMode(MODE::SINGLE); //set to single mode so all leds are used as one
 
-    m_filter_color_r.setTarget(c.r);
-    m_filter_color_g.setTarget(c.g);
-    m_filter_color_b.setTarget(c.b);
+    m_transition.setTarget(TRANSITION_R, c.r);
+    m_transition.setTarget(TRANSITION_G, c.g);
+    m_transition.setTarget(TRANSITION_B, c.b);
     return *this;
   }
 
@@ -205,8 +828,36 @@ public:
     return m_leds[0];
   }
 
+  /**
+   * start a smooth transition of all leds in many mode
+   * the current frame is used as start frame, all changes to individual leds after this call fade in over duration
+   * @param duration transition time in ms
+  */
+  LED_Strip &beginCrossfade(const uint16_t duration)
+  {
+    // raw buffer is stale outside of many mode -> the visible frame is the single color
+    if (m_led_mode == MODE::MANY && m_leds_raw)
+      m_crossfade.begin(m_leds_raw, m_num_leds, duration);
+    else
+      m_crossfade.begin(m_single_color, m_num_leds, duration);
+    return *this;
+  }
+
+  inline bool isCrossfading()
+  {
+    return m_crossfade.isActive();
+  }
+
   inline LED_Strip &setMode(MODE mode)
   {
+    // raw buffer is not maintained in single and palette mode -> start many mode with the colors shown before
+    if (mode == MODE::MANY && m_led_mode == MODE::PALETTE && m_indices)
+      expandPalette();
+    else if (mode == MODE::MANY && m_led_mode != MODE::MANY && m_leds_raw)
+      fillRaw(m_single_color);
+    // palette mode starts with all leds at entry 0, raw and index buffer share m_raw_head
+    if (mode == MODE::PALETTE && m_led_mode != MODE::PALETTE)
+      fillIndices(0);
     this->m_led_mode = mode;
     return *this;
   }
@@ -216,6 +867,158 @@ public:
     return m_led_mode;
   }
 
+  /**
+   * @returns number of bytes allocated on the heap for led buffers
+  */
+  size_t getHeapUsage()
+  {
+    size_t bytes = m_owns_leds ? m_num_leds * sizeof(CRGB) : 0;
+    if (m_leds_raw)
+      bytes += m_num_leds * sizeof(CRGB);
+    if (m_dither_table)
+      bytes += sizeof(DitheredColorTable) + m_num_leds * 3;
+    if (m_indices)
+      bytes += m_num_leds;
+    if (m_palette)
+      bytes += m_palette_size * (2 * sizeof(CRGB) + sizeof(uint16_t));
+    return bytes + m_crossfade.getHeapUsage();
+  }
+
+  /**
+   * write mode, power, brightness, color, correction, transition time and leds as compact binary snapshot
+   * format: 'L' 'S' version flags brightness r g b correction_r g b transition_time(2) num_leds(2)
+   * followed by the run length coded leds if flags & 4 and a Fletcher-16 checksum, numbers are little endian
+   * @returns number of bytes written
+  */
+  size_t saveState(Print &out)
+  {
+    LED_Checksum_Print p(out);
+    // palette mode is stored as many mode
+    bool palette = m_led_mode == MODE::PALETTE;
+    bool pixels = (m_led_mode == MODE::MANY && m_leds_raw) || palette;
+    uint16_t duration = m_transition.getDuration();
+    uint8_t header[15] = {
+        'L', 'S', STATE_VERSION,
+        (uint8_t)(m_power | (m_led_mode != MODE::SINGLE) << 1 | pixels << 2),
+        m_brightness_target,
+        m_transition.getTarget(TRANSITION_R), m_transition.getTarget(TRANSITION_G), m_transition.getTarget(TRANSITION_B),
+        m_color_correction.r, m_color_correction.g, m_color_correction.b,
+        (uint8_t)duration, (uint8_t)(duration >> 8),
+        (uint8_t)m_num_leds, (uint8_t)(m_num_leds >> 8)};
+    size_t bytes = p.write(header, sizeof(header));
+
+    if (pixels)
+      bytes += ledRleEncode(p, m_num_leds, [this, palette](const uint16_t i) -> const CRGB & { return palette ? m_palette[m_indices[rawIndex(i)]] : m_leds_raw[rawIndex(i)]; });
+
+    uint16_t checksum = p.checksum.get();
+    bytes += out.write((uint8_t)checksum);
+    bytes += out.write((uint8_t)(checksum >> 8));
+    return bytes;
+  }
+
+  /**
+   * restore a snapshot written by saveState() in one pass, transitions jump to the restored state
+   * leds are decoded into the output buffer first, it is rebuilt from the raw buffer by the next render anyway,
+   * so an invalid snapshot leaves the strip untouched without needing another buffer
+   * @returns false if the snapshot is invalid or was taken from a strip with a different number of leds
+  */
+  bool restoreState(Stream &in)
+  {
+    LED_Checksum_Source src(in);
+    uint8_t h[15];
+    if (src.read(h, sizeof(h)) != sizeof(h) || h[0] != 'L' || h[1] != 'S' || h[2] != STATE_VERSION)
+      return false;
+    if ((uint16_t)(h[13] | h[14] << 8) != m_num_leds)
+      return false;
+
+    bool pixels = h[3] & 4;
+    bool valid = true;
+    if (pixels)
+    {
+      CRGB *scratch = m_leds;
+      valid = ledRleDecode(src, m_num_leds, [scratch](const uint16_t i, const CRGB &c) { scratch[i] = c; });
+    }
+
+    uint16_t checksum = src.checksum.get();
+    uint8_t stored[2];
+    if (!valid || in.readBytes(stored, 2) != 2 || (uint16_t)(stored[0] | stored[1] << 8) != checksum)
+    { // output buffer may be partly overwritten
+      markAllDirty();
+      return false;
+    }
+
+    if (pixels)
+    {
+      memcpy(rawLeds(), m_leds, m_num_leds * sizeof(CRGB));
+      m_raw_head = 0;
+    }
+
+    m_power = h[3] & 1;
+    m_led_mode = h[3] & 2 ? MODE::MANY : MODE::SINGLE;
+    m_brightness_target = h[4];
+    m_single_color = CRGB(h[5], h[6], h[7]);
+    m_color_correction = CRGB(h[8], h[9], h[10]);
+    uint8_t values[4] = {(uint8_t)(m_power ? h[4] : 0), h[5], h[6], h[7]};
+    m_transition.init(values, h[11] | h[12] << 8);
+
+    if (m_leds_raw && !pixels)
+      fillRaw(m_single_color);
+    powerRecalc();
+    markAllDirty();
+    return true;
+  }
+
+#if LED_STRIP_STATS
+  inline const LED_Strip_Stats &getStats()
+  {
+    return m_stats;
+  }
+
+  inline LED_Strip &resetStats()
+  {
+    m_stats = LED_Strip_Stats();
+    return *this;
+  }
+#endif
+
+  /**
+   * earliest time the strip has to be updated again, the main loop may sleep until then
+   * every change made through the api afterwards is due immediately, so check again after changing the strip
+   * @returns time in ms until the next update is necessary, 0 if it is due now, NEVER for a static settled scene
+  */
+  uint32_t nextUpdateDue()
+  {
+    if (m_commands && m_commands->pending())
+      return 0;
+
+    if (m_segments)
+    { // parent is updated whenever a segment needs it
+      if (m_segments_rendered)
+        return 0;
+      uint32_t due = NEVER;
+      for (LED_Strip *s = m_segments; s; s = s->m_next_segment)
+      {
+        due = min(due, s->nextUpdateDue());
+      }
+      return due;
+    }
+
+    // pending changes, dithering and crossfades need every frame
+    if (isDirty() || m_led_mode != m_rendered_mode || m_dither_table || m_crossfade.isActive())
+      return 0;
+    if ((m_power ? m_brightness_target : 0) != m_transition.getTarget(TRANSITION_BRI))
+      return 0;
+    return m_transition.timeUntilNextUpdate(millis());
+  }
+
+  /**
+   * @returns true if brightness and color transitions are finished
+  */
+  inline bool isSettled()
+  {
+    return m_settled;
+  }
+
   inline LED_Strip &operator<<(const CRGB c)
   {
     return setColor(c);
@@ -226,8 +1029,73 @@ public:
     return setBrightness(b);
   }
 
+  /**
+   * calculate leds without writing them to the hardware
+   * used to batch the output of several strips
+   * @returns true if the output changed and show() has to be called
+  */
+  bool render()
+  {
+    if (m_segments)
+    { // output buffer belongs to segments -> render only those, queued changes of this strip are still applied
+      if (m_commands)
+        m_commands->apply();
+      m_leds_changed = m_segments_rendered;
+      m_segments_rendered = false;
+      for (LED_Strip *s = m_segments; s; s = s->m_next_segment)
+      {
+        m_leds_changed |= s->render();
+      }
+      return m_leds_changed;
+    }
+
+    updateLeds();
+    return isUpdateNecessary();
+  }
+
+  // virtual interface method for writing calculated leds to the hardware
+  virtual void show() = 0;
+
+  /**
+   * write leds to the hardware using show() and record the output time
+  */
+  void output()
+  {
+#if LED_STRIP_STATS
+    uint32_t start = micros();
+    show();
+    uint32_t t = micros() - start;
+    m_stats.output_time.add(t);
+    if (isOutputBlocking() && t > m_stats.irq_off_max)
+      m_stats.irq_off_max = t;
+#else
+    show();
+#endif
+  }
+
+  // true if show() runs with interrupts disabled
+  virtual bool isOutputBlocking()
+  {
+    return false;
+  }
+
+  /**
+   * estimated time in us the hardware needs to receive one frame
+   * used to report the output time of batched strips
+  */
+  virtual uint32_t getOutputTime()
+  {
+    return 0;
+  }
+
   // virtual interface method for updating
-  virtual void update() = 0;
+  virtual void update()
+  {
+    if (render())
+    {
+      output();
+    }
+  }
 };
 
 #endif //LED_STRIP_H
@@ -0,0 +1,87 @@
+#ifndef LED_STRIP_GROUP_H
+#define LED_STRIP_GROUP_H
+
+#include <LED_Strip.h>
+
+/**
+ * updates several strips with one batched output phase per frame
+ * all strips are rendered first, afterwards every changed strip is shown back to back
+ * so the time with interrupts disabled is not interleaved with render work
+*/
+template <uint8_t MAX_STRIPS = 8>
+class LED_Strip_Group
+{
+public:
+  struct Stats
+  {
+    uint8_t shown = 0;             // strips written during last frame
+    uint32_t output_time = 0;      // measured duration of last output phase in us
+    uint32_t output_time_max = 0;  // longest output phase in us
+    uint32_t modeled_time = 0;     // estimated wire time of last frame in us
+  };
+
+protected:
+  LED_Strip *m_strips[MAX_STRIPS];
+  bool m_changed[MAX_STRIPS];
+  uint8_t m_num_strips = 0;
+
+  Stats m_stats;
+
+public:
+  /**
+   * add strip to group, strips in a group must not be updated separately
+   * @returns false if no more strips can be added
+  */
+  bool add(LED_Strip &strip)
+  {
+    if (m_num_strips >= MAX_STRIPS)
+      return false;
+    m_strips[m_num_strips++] = &strip;
+    return true;
+  }
+
+  /**
+   * render all strips and write changed strips in one output phase
+   * @returns true if any strip has been written
+  */
+  bool update()
+  {
+    // render phase
+    bool any = false;
+    for (uint8_t i = 0; i < m_num_strips; i++)
+    {
+      m_changed[i] = m_strips[i]->render();
+      any |= m_changed[i];
+    }
+
+    m_stats.shown = 0;
+    m_stats.output_time = 0;
+    m_stats.modeled_time = 0;
+    if (!any)
+      return false;
+
+    // output phase
+    uint32_t start = micros();
+    for (uint8_t i = 0; i < m_num_strips; i++)
+    {
+      if (m_changed[i])
+      {
+        m_strips[i]->output();
+        m_stats.modeled_time += m_strips[i]->getOutputTime();
+        m_stats.shown++;
+      }
+    }
+    m_stats.output_time = micros() - start;
+    if (m_stats.output_time > m_stats.output_time_max)
+      m_stats.output_time_max = m_stats.output_time;
+
+    return true;
+  }
+
+  inline const Stats &getStats()
+  {
+    return m_stats;
+  }
+};
+
+#endif //LED_STRIP_GROUP_H
@@ -0,0 +1,80 @@
+#ifndef LED_STRIP_STATS_H
+#define LED_STRIP_STATS_H
+
+#include <Arduino.h>
+#include <Printable.h>
+
+// define LED_STRIP_STATS 1 before including any strip to enable performance counters
+#ifndef LED_STRIP_STATS
+#define LED_STRIP_STATS 0
+#endif
+
+/**
+ * minimum, average and maximum of a duration in us
+ * the average is a moving average over roughly 16 samples
+*/
+class LED_Timing : public Printable
+{
+public:
+  uint32_t min = 0;
+  uint32_t avg = 0;
+  uint32_t max = 0;
+  uint32_t count = 0;
+
+  void add(const uint32_t t)
+  {
+    if (count == 0 || t < min)
+      min = t;
+    if (t > max)
+      max = t;
+    avg = count == 0 ? t : avg + ((int32_t)t - (int32_t)avg) / 16;
+    count++;
+  }
+
+  size_t printTo(Print &p) const
+  { //allow printing to Serial
+    size_t s = 0;
+    s += p.print(min);
+    s += p.print("/");
+    s += p.print(avg);
+    s += p.print("/");
+    s += p.print(max);
+    s += p.print("us");
+    return s;
+  }
+};
+
+/**
+ * performance counters of one strip
+*/
+class LED_Strip_Stats : public Printable
+{
+public:
+  uint32_t frames_rendered = 0;   // renders that changed the output
+  uint32_t frames_skipped = 0;    // renders without change, output was not necessary
+  uint32_t pixels_recomputed = 0; // leds written to the output buffer
+  LED_Timing render_time;         // time spent in updateLeds()
+  LED_Timing output_time;         // time spent writing to the hardware
+  uint32_t irq_off_max = 0;       // longest output with interrupts disabled in us
+
+  size_t printTo(Print &p) const
+  { //allow printing to Serial
+    size_t s = 0;
+    s += p.print("frames:");
+    s += p.print(frames_rendered);
+    s += p.print(" skipped:");
+    s += p.print(frames_skipped);
+    s += p.print(" pixels:");
+    s += p.print(pixels_recomputed);
+    s += p.print(" render:");
+    s += p.print(render_time);
+    s += p.print(" output:");
+    s += p.print(output_time);
+    s += p.print(" irq_off:");
+    s += p.print(irq_off_max);
+    s += p.print("us");
+    return s;
+  }
+};
+
+#endif //LED_STRIP_STATS_H
@@ -0,0 +1,240 @@
+#ifndef LED_TRANSITION_H
+#define LED_TRANSITION_H
+
+#include <Arduino.h>
+
+/**
+ * smooth transition of several 8 bit channels sharing one duration and easing curve
+ * all channels are updated together in fixed point with one time stamp per frame
+ * a new target restarts the transition from the current values so changes stay continuous
+*/
+template <uint8_t CHANNELS>
+class LED_Transition
+{
+public:
+  enum EASING
+  {
+    LINEAR,
+    EASE_IN_OUT, // smoothstep
+    EXPONENTIAL  // fast start, slow end
+  };
+
+  static const uint32_t NEVER = 0xFFFFFFFF; // no update necessary until a new target is set
+
+protected:
+  uint8_t m_value[CHANNELS];
+  uint8_t m_start[CHANNELS];
+  uint8_t m_target[CHANNELS];
+
+  uint16_t m_duration = 0; // in ms
+  EASING m_easing = EASING::LINEAR;
+  uint32_t m_start_time = 0;
+  bool m_active = false;   // transition running
+  bool m_retarget = false; // a target changed, transition starts with next update
+
+  /**
+   * @param p progress 0 - 65536
+   * @returns eased progress 0 - 65536
+  */
+  uint32_t ease(const uint32_t p)
+  {
+    switch (m_easing)
+    {
+    case EASING::EASE_IN_OUT:
+    { // p^2 * (3 - 2p), rounded once so the curve stays monotonic
+      return ((uint64_t)p * p * ((3UL << 16) - 2 * p)) >> 32;
+    }
+    case EASING::EXPONENTIAL:
+    { // 1 - 2^(-10p), 2^-f of the fractional part approximated by a parabola
+      uint32_t e = p * 10;
+      uint32_t f = e & 0xFFFF;
+      uint32_t r = 65536 - ((43024 * f) >> 16) + ((10257 * ((f * f) >> 16)) >> 16);
+      return 65536 - (r >> (e >> 16));
+    }
+    default:
+      return p;
+    }
+  }
+
+  /**
+   * @param t time since start in ms, t < m_duration
+   * @returns eased progress 0 - 65536 at time t, the same value update() uses
+  */
+  inline uint32_t progressAt(const uint32_t t)
+  {
+    return ease((t << 16) / m_duration);
+  }
+
+  /**
+   * eased progress at which channel i leaves its current value
+   * @returns threshold in 0 - 65536, more than 65536 if the channel does not change before the end
+  */
+  uint32_t nextStepProgress(const uint8_t i)
+  {
+    const int32_t d = (int32_t)m_target[i] - m_start[i];
+    const int32_t s = (int32_t)m_value[i] - m_start[i]; // current step, value = start + (d * progress >> 16)
+    if (d == 0 || s == d)
+      return 0x10001;
+    if (d > 0) // first progress with d * progress >= (s + 1) << 16
+      return (((uint32_t)(s + 1) << 16) + d - 1) / d;
+    // first progress with d * progress < s << 16, the shift rounds towards minus infinity
+    return ((uint32_t)(-s) << 16) / (uint32_t)(-d) + 1;
+  }
+
+public:
+  LED_Transition()
+  {
+    memset(m_value, 0, CHANNELS);
+    memset(m_start, 0, CHANNELS);
+    memset(m_target, 0, CHANNELS);
+  }
+
+  /**
+   * set all channels without transition
+  */
+  void init(const uint8_t *values, const uint16_t duration)
+  {
+    memcpy(m_value, values, CHANNELS);
+    memcpy(m_target, values, CHANNELS);
+    m_duration = duration;
+    m_active = false;
+    m_retarget = false;
+  }
+
+  inline void setDuration(const uint16_t duration)
+  {
+    m_duration = duration;
+  }
+
+  inline uint16_t getDuration()
+  {
+    return m_duration;
+  }
+
+  inline void setEasing(const EASING easing)
+  {
+    m_easing = easing;
+  }
+
+  inline EASING getEasing()
+  {
+    return m_easing;
+  }
+
+  /**
+   * set target of one channel, the transition starts with the next update
+  */
+  inline void setTarget(const uint8_t channel, const uint8_t target)
+  {
+    if (m_target[channel] == target)
+      return;
+    m_target[channel] = target;
+    m_retarget = true;
+  }
+
+  inline uint8_t getTarget(const uint8_t channel)
+  {
+    return m_target[channel];
+  }
+
+  inline uint8_t getValue(const uint8_t channel)
+  {
+    return m_value[channel];
+  }
+
+  /**
+   * advance all channels to time now
+   * @param now current time in ms, read once per frame by the caller
+   * @returns true if any value changed
+  */
+  bool update(const uint32_t now)
+  {
+    if (m_retarget)
+    {
+      memcpy(m_start, m_value, CHANNELS);
+      m_start_time = now;
+      m_active = true;
+      m_retarget = false;
+    }
+    if (!m_active)
+      return false;
+
+    uint32_t elapsed = now - m_start_time;
+    bool changed = false;
+    if (elapsed >= m_duration)
+    { // finished
+      for (uint8_t i = 0; i < CHANNELS; i++)
+      {
+        changed |= m_value[i] != m_target[i];
+        m_value[i] = m_target[i];
+      }
+      m_active = false;
+      return changed;
+    }
+
+    int32_t progress = progressAt(elapsed);
+    for (uint8_t i = 0; i < CHANNELS; i++)
+    {
+      uint8_t v = m_start[i] + (((int32_t)m_target[i] - m_start[i]) * progress >> 16);
+      changed |= m_value[i] != v;
+      m_value[i] = v;
+    }
+    return changed;
+  }
+
+  /**
+   * @returns true if all channels reached their targets and no transition is pending
+  */
+  inline bool settled()
+  {
+    return !m_active && !m_retarget;
+  }
+
+  /**
+   * calculate when the next value changes
+   * @param now current time in ms
+   * @returns time in ms until the next update is necessary, 0 if it is due, NEVER if settled
+  */
+  uint32_t timeUntilNextUpdate(const uint32_t now)
+  {
+    if (m_retarget)
+      return 0;
+    if (!m_active)
+      return NEVER;
+
+    uint32_t elapsed = now - m_start_time;
+    if (elapsed >= m_duration)
+      return 0;
+
+    // the channel that changes first defines the next update
+    uint32_t threshold = 0x10001;
+    for (uint8_t i = 0; i < CHANNELS; i++)
+    {
+      threshold = min(threshold, nextStepProgress(i));
+    }
+
+    // first time at which the eased progress reaches the threshold, the transition ends at m_duration in any case
+    uint32_t t;
+    if (threshold > 0x10000)
+      t = m_duration;
+    else if (m_easing == EASING::LINEAR) // (t << 16) / duration >= threshold
+      t = min((uint32_t)m_duration, (threshold * m_duration + 0xFFFF) >> 16);
+    else
+    { // easing curves are monotonic -> binary search
+      uint32_t lo = 0;
+      uint32_t hi = m_duration;
+      while (lo < hi)
+      {
+        uint32_t mid = (lo + hi) / 2;
+        if (progressAt(mid) >= threshold)
+          hi = mid;
+        else
+          lo = mid + 1;
+      }
+      t = lo;
+    }
+    return t > elapsed ? t - elapsed : 0;
+  }
+};
+
+#endif //LED_TRANSITION_H
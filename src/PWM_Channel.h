@@ -0,0 +1,65 @@
+#ifndef PWM_CHANNEL_H
+#define PWM_CHANNEL_H
+
+#include <Arduino.h>
+
+/**
+ * one pwm pin that is only written if its value changed
+ * reprogramming the pwm timer is not free, so unchanged values are skipped
+*/
+class PWM_Channel
+{
+protected:
+  uint8_t m_pin;
+  int32_t m_value = -1; // last written value, -1 -> pin has not been written yet
+
+public:
+  PWM_Channel(const uint8_t pin) : m_pin(pin) {}
+
+  /**
+   * @returns true if the value has been written to the pin
+  */
+  inline bool write(const uint16_t value)
+  {
+    if (value == m_value)
+      return false;
+    analogWrite(m_pin, value);
+    m_value = value;
+    return true;
+  }
+
+  /**
+   * write 16 bit value with the given resolution
+   * @param bits pwm resolution, the range has to be set to (1 << bits) - 1
+  */
+  inline bool write16(const uint16_t value, const uint8_t bits)
+  {
+    return write(value >> (16 - bits));
+  }
+
+  // next write() is executed even if the value did not change, necessary after changing range or frequency
+  inline void invalidate()
+  {
+    m_value = -1;
+  }
+
+  inline uint8_t getPin()
+  {
+    return m_pin;
+  }
+};
+
+/**
+ * set resolution and frequency of all pwm pins
+ * the esp8266 shares range and frequency between all pins
+ * @param bits resolution from 8 to 16 bit
+*/
+inline uint8_t pwmConfigure(uint8_t bits, const uint32_t frequency)
+{
+  bits = constrain(bits, 8, 16);
+  analogWriteRange((1UL << bits) - 1);
+  analogWriteFreq(frequency);
+  return bits;
+}
+
+#endif //PWM_CHANNEL_H
@@ -1,27 +1,50 @@
 #pragma once
 
 #include <LED_Strip.h>
+#include <PWM_Channel.h>
 
 class PWM_Dimmable_LED_Strip : public LED_Strip
 {
   private:
-    uint8_t m_pin;
+    PWM_Channel m_pwm;
+    uint8_t m_bits; // pwm resolution
 
   public:
-    PWM_Dimmable_LED_Strip(uint8_t p_pin)
-        : LED_Strip(1), m_pin(p_pin)
+    /**
+     * @param bits pwm resolution from 8 to 16 bit, higher resolutions make low brightness smoother
+     * @param frequency pwm frequency in Hz
+    */
+    PWM_Dimmable_LED_Strip(uint8_t p_pin, const uint8_t bits = 8, const uint32_t frequency = 200)
+        : LED_Strip(1), m_pwm(p_pin)
     {
-        analogWriteFreq(200);
-        analogWriteRange(255);
+        m_bits = pwmConfigure(bits, frequency);
     }
 
-    // implement update method
+    /**
+     * change resolution and frequency, affects all pwm pins
+    */
+    PWM_Dimmable_LED_Strip &setPwm(const uint8_t bits, const uint32_t frequency)
+    {
+        m_bits = pwmConfigure(bits, frequency);
+        m_pwm.invalidate();
+        return *this;
+    }
+
+    inline uint8_t getPwmBits()
+    {
+        return m_bits;
+    }
+
+    // implement show method, pwm channel is only written if it changed
+    virtual void show() override
+    {
+        m_pwm.write16(ledLinBrightness_16bit(m_rendered_bri << 8), m_bits);
+    }
+
+    // implement update method, output is cheap if nothing changed
     virtual void update() override
     {
         LED_Strip::updateLeds();
-
-        uint8_t bri = getBrightness();
-        bri = ledLinBrightness(bri);
-        analogWrite(m_pin, bri);
+        output();
     }
-};
\ No newline at end of file
+};
@@ -2,29 +2,56 @@
 #define PWM_LED_STRIP_H
 
 #include <LED_Strip.h>
+#include <PWM_Channel.h>
 
 class PWM_RGB_LED_Strip : public LED_Strip
 {
 protected:
-  uint8_t m_pwm_r, m_pwm_g, m_pwm_b;
+  PWM_Channel m_pwm_r, m_pwm_g, m_pwm_b;
+  uint8_t m_bits; // pwm resolution
 
 public:
-  PWM_RGB_LED_Strip(const uint8_t pwm_R, const uint8_t pwm_G, const uint8_t pwm_B)
+  /**
+   * @param bits pwm resolution from 8 to 16 bit, higher resolutions make dim colors smoother
+   * @param frequency pwm frequency in Hz
+  */
+  PWM_RGB_LED_Strip(const uint8_t pwm_R, const uint8_t pwm_G, const uint8_t pwm_B, const uint8_t bits = 8, const uint32_t frequency = 200)
       : LED_Strip(1), m_pwm_r(pwm_R), m_pwm_g(pwm_G), m_pwm_b(pwm_B)
   {
-    analogWriteFreq(200);
-    analogWriteRange(255);
+    m_bits = pwmConfigure(bits, frequency);
   }
 
-  // implement update method
+  /**
+   * change resolution and frequency, affects all pwm pins
+  */
+  PWM_RGB_LED_Strip &setPwm(const uint8_t bits, const uint32_t frequency)
+  {
+    m_bits = pwmConfigure(bits, frequency);
+    m_pwm_r.invalidate();
+    m_pwm_g.invalidate();
+    m_pwm_b.invalidate();
+    return *this;
+  }
+
+  inline uint8_t getPwmBits()
+  {
+    return m_bits;
+  }
+
+  // implement show method, channels are calculated with 16 bit and only written if they changed
+  virtual void show() override
+  {
+    const CRGB &col = m_led_mode == MODE::MANY && m_leds_raw ? m_leds_raw[0] : m_single_color;
+    m_pwm_r.write16(scaledChannel16(col.r, m_rendered_bri, m_color_correction.r), m_bits);
+    m_pwm_g.write16(scaledChannel16(col.g, m_rendered_bri, m_color_correction.g), m_bits);
+    m_pwm_b.write16(scaledChannel16(col.b, m_rendered_bri, m_color_correction.b), m_bits);
+  }
+
+  // implement update method, brightness steps finer than the 8 bit output buffer have to reach the pins as well
   virtual void update() override
   {
     LED_Strip::updateLeds();
-
-    CRGB &col = getColor();
-    analogWrite(m_pwm_r, col.r);
-    analogWrite(m_pwm_g, col.g);
-    analogWrite(m_pwm_b, col.b);
+    output();
   }
 };
 
@@ -2,7 +2,7 @@
 
 #include <Arduino.h>
 
-uint8_t ledLinBrightness(uint8_t x)
+inline uint8_t ledLinBrightness(uint8_t x)
 {
 
   uint16_t ret = x / 4; // 0 <= x < 256/4
@@ -15,14 +15,14 @@ uint8_t ledLinBrightness(uint8_t x)
   { // 512/4 <= x < 768/4
     ret = x - 80;
   }
-  else if (x >= 192 && x < 256)
+  else if (x >= 192)
   { // 768/4 <= x < 1024/4
     ret = 2 * x - 272;
   }
   return ret;
 }
 
-uint16_t ledLinBrightness_10bit(uint16_t x)
+inline uint16_t ledLinBrightness_10bit(uint16_t x)
 {
 
   uint16_t ret = x / 4; // 0 <= x < 256
@@ -42,7 +42,41 @@ uint16_t ledLinBrightness_10bit(uint16_t x)
   return ret;
 }
 
-CRGB scaledColor(CRGB c, uint8_t brightness, const CRGB &correction)
+/**
+ * same curve as ledLinBrightness() for 16 bit values
+ * an 8 bit value x corresponds to x << 8
+*/
+inline uint16_t ledLinBrightness_16bit(uint16_t x)
+{
+
+  uint32_t ret = x / 4; // 0 <= x < 16384
+
+  if (x >= 16384 && x < 32768)
+  { // 16384 <= x < 32768
+    ret = x / 2 - 4096;
+  }
+  else if (x >= 32768 && x < 49152)
+  { // 32768 <= x < 49152
+    ret = x - 20480;
+  }
+  else if (x >= 49152)
+  { // 49152 <= x < 65536
+    ret = 2 * (uint32_t)x - 69632;
+  }
+  return ret;
+}
+
+/**
+ * 16 bit version of one channel of scaledColor()
+ * same scaling as scale8() but keeping the fraction, the result can be reduced to any output resolution
+*/
+inline uint16_t scaledChannel16(const uint8_t x, const uint8_t brightness, const uint8_t correction)
+{
+  uint32_t lin = ((uint32_t)ledLinBrightness_16bit(x << 8) * (brightness + 1)) >> 8;
+  return (lin * (correction + 1)) >> 8;
+}
+
+inline CRGB scaledColor(CRGB c, uint8_t brightness, const CRGB &correction)
 {
   c.r = ledLinBrightness(c.r); //adjust for logarithmic sensation of eye
   c.g = ledLinBrightness(c.g);
@@ -53,3 +87,104 @@ CRGB scaledColor(CRGB c, uint8_t brightness, const CRGB &correction)
 
   return c;
 }
+
+/**
+ * lookup table for scaledColor() with one entry per channel value
+ * folds linearization, brightness and color correction together so scaling a pixel costs three table loads
+ * the table is only rebuilt if brightness or correction change
+*/
+class ScaledColorTable
+{
+protected:
+  uint8_t m_r[256];
+  uint8_t m_g[256];
+  uint8_t m_b[256];
+
+  uint8_t m_brightness = 0;
+  CRGB m_correction = 0;
+  bool m_valid = false;
+
+public:
+  /**
+   * rebuild table if brightness or correction differ from the cached values
+   * @returns true if the table has been rebuilt
+  */
+  bool update(const uint8_t brightness, const CRGB &correction)
+  {
+    if (m_valid && brightness == m_brightness && correction == m_correction)
+      return false;
+
+    for (uint16_t x = 0; x < 256; x++)
+    {
+      // same order of operations as scaledColor() so results are identical
+      uint8_t lin = scale8(ledLinBrightness(x), brightness);
+      m_r[x] = scale8(lin, correction.r);
+      m_g[x] = scale8(lin, correction.g);
+      m_b[x] = scale8(lin, correction.b);
+    }
+
+    m_brightness = brightness;
+    m_correction = correction;
+    m_valid = true;
+    return true;
+  }
+
+  inline CRGB scale(const CRGB &c) const
+  {
+    return CRGB(m_r[c.r], m_g[c.g], m_b[c.b]);
+  }
+};
+
+/**
+ * 16 bit version of ScaledColorTable with temporal dithering to 8 bit output
+ * the fraction lost when reducing to 8 bit is carried to the next frame, so dim colors get more than 8 bit of resolution
+*/
+class DitheredColorTable
+{
+protected:
+  uint16_t m_r[256];
+  uint16_t m_g[256];
+  uint16_t m_b[256];
+
+  uint8_t m_brightness = 0;
+  CRGB m_correction = 0;
+  bool m_valid = false;
+
+public:
+  /**
+   * rebuild table if brightness or correction differ from the cached values
+   * @returns true if the table has been rebuilt
+  */
+  bool update(const uint8_t brightness, const CRGB &correction)
+  {
+    if (m_valid && brightness == m_brightness && correction == m_correction)
+      return false;
+
+    for (uint16_t x = 0; x < 256; x++)
+    {
+      m_r[x] = scaledChannel16(x, brightness, correction.r);
+      m_g[x] = scaledChannel16(x, brightness, correction.g);
+      m_b[x] = scaledChannel16(x, brightness, correction.b);
+    }
+
+    m_brightness = brightness;
+    m_correction = correction;
+    m_valid = true;
+    return true;
+  }
+
+  /**
+   * scale color to 8 bit output
+   * @param err fraction carried between frames, one byte per channel
+  */
+  inline CRGB dither(const CRGB &c, uint8_t *err) const
+  {
+    uint16_t r = m_r[c.r] + err[0];
+    uint16_t g = m_g[c.g] + err[1];
+    uint16_t b = m_b[c.b] + err[2];
+    err[0] = r;
+    err[1] = g;
+    err[2] = b;
+    return CRGB(r >> 8, g >> 8, b >> 8);
+  }
+};
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <FastLED.h>
+
+/**
+ * bulk operations on the raw byte stream of led buffers
+ * several channels are processed per machine word (SWAR), 4 on the ESP8266 and 8 on 64 bit hosts
+ * hosts with AVX2, SSE2 or NEON process 32 or 16 channels per vector first, define LED_KERNELS_NO_SIMD to only use SWAR
+ * results are identical to the per led FastLED functions
+*/
+
+#if defined(LED_KERNELS_NO_SIMD)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LED_KERNELS_AVX2 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LED_KERNELS_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define LED_KERNELS_NEON 1
+#endif
+
+typedef uintptr_t led_word_t;
+
+// 0x00FF00FF... for the width of led_word_t
+static const led_word_t LED_WORD_LO = (led_word_t)~(led_word_t)0 / 0xFFFF * 0xFF;
+// 0x80808080... for the width of led_word_t
+static const led_word_t LED_WORD_H = (led_word_t)~(led_word_t)0 / 0xFF * 0x80;
+
+inline led_word_t ledLoadWord(const uint8_t *p)
+{
+  led_word_t w;
+  memcpy(&w, p, sizeof(w)); // buffers are not word aligned
+  return w;
+}
+
+inline void ledStoreWord(uint8_t *p, const led_word_t w)
+{
+  memcpy(p, &w, sizeof(w));
+}
+
+/**
+ * 0xFF in every byte where a >= b, 0x00 otherwise
+*/
+inline led_word_t ledMaskGreaterEqual(const led_word_t a, const led_word_t b)
+{
+  // compare lower 7 bits, the set top bit of a keeps borrows inside each byte
+  led_word_t low = (a | LED_WORD_H) - (b & ~LED_WORD_H);
+  // top bits decide unless they are equal
+  led_word_t ge = ((a & ~b) | (~(a ^ b) & low)) & LED_WORD_H;
+  return (ge >> 7) * 0xFF;
+}
+
+/**
+ * vector versions of the kernels
+ * each processes whole vectors from the start of the buffer and returns the number of channels done
+*/
+#if defined(LED_KERNELS_AVX2)
+inline size_t ledVectorScale8(uint8_t *p, const size_t n, const uint16_t s)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i f = _mm256_set1_epi16(s);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32)
+  {
+    __m256i v = _mm256_loadu_si256((const __m256i *)(p + i));
+    // unpack and pack both work within 128 bit lanes, so the order is kept
+    __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(v, zero), f), 8);
+    __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(v, zero), f), 8);
+    _mm256_storeu_si256((__m256i *)(p + i), _mm256_packus_epi16(lo, hi));
+  }
+  return i;
+}
+
+#define LED_VECTOR_BINARY(name, op)                                  \
+  inline size_t name(uint8_t *dst, const uint8_t *src, const size_t n) \
+  {                                                                   \
+    size_t i = 0;                                                     \
+    for (; i + 32 <= n; i += 32)                                      \
+    {                                                                 \
+      __m256i a = _mm256_loadu_si256((const __m256i *)(dst + i));     \
+      __m256i b = _mm256_loadu_si256((const __m256i *)(src + i));     \
+      _mm256_storeu_si256((__m256i *)(dst + i), op(a, b));            \
+    }                                                                 \
+    return i;                                                         \
+  }
+LED_VECTOR_BINARY(ledVectorAdd8, _mm256_adds_epu8)
+LED_VECTOR_BINARY(ledVectorMax8, _mm256_max_epu8)
+LED_VECTOR_BINARY(ledVectorMin8, _mm256_min_epu8)
+#undef LED_VECTOR_BINARY
+
+#elif defined(LED_KERNELS_SSE2)
+inline size_t ledVectorScale8(uint8_t *p, const size_t n, const uint16_t s)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i f = _mm_set1_epi16(s);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    __m128i v = _mm_loadu_si128((const __m128i *)(p + i));
+    __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(v, zero), f), 8);
+    __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(v, zero), f), 8);
+    _mm_storeu_si128((__m128i *)(p + i), _mm_packus_epi16(lo, hi));
+  }
+  return i;
+}
+
+#define LED_VECTOR_BINARY(name, op)                                  \
+  inline size_t name(uint8_t *dst, const uint8_t *src, const size_t n) \
+  {                                                                   \
+    size_t i = 0;                                                     \
+    for (; i + 16 <= n; i += 16)                                      \
+    {                                                                 \
+      __m128i a = _mm_loadu_si128((const __m128i *)(dst + i));        \
+      __m128i b = _mm_loadu_si128((const __m128i *)(src + i));        \
+      _mm_storeu_si128((__m128i *)(dst + i), op(a, b));               \
+    }                                                                 \
+    return i;                                                         \
+  }
+LED_VECTOR_BINARY(ledVectorAdd8, _mm_adds_epu8)
+LED_VECTOR_BINARY(ledVectorMax8, _mm_max_epu8)
+LED_VECTOR_BINARY(ledVectorMin8, _mm_min_epu8)
+#undef LED_VECTOR_BINARY
+
+#elif defined(LED_KERNELS_NEON)
+inline size_t ledVectorScale8(uint8_t *p, const size_t n, const uint16_t s)
+{
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+  {
+    uint8x16_t v = vld1q_u8(p + i);
+    uint16x8_t lo = vmulq_n_u16(vmovl_u8(vget_low_u8(v)), s);
+    uint16x8_t hi = vmulq_n_u16(vmovl_u8(vget_high_u8(v)), s);
+    vst1q_u8(p + i, vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8)));
+  }
+  return i;
+}
+
+#define LED_VECTOR_BINARY(name, op)                                  \
+  inline size_t name(uint8_t *dst, const uint8_t *src, const size_t n) \
+  {                                                                   \
+    size_t i = 0;                                                     \
+    for (; i + 16 <= n; i += 16)                                      \
+    {                                                                 \
+      vst1q_u8(dst + i, op(vld1q_u8(dst + i), vld1q_u8(src + i)));    \
+    }                                                                 \
+    return i;                                                         \
+  }
+LED_VECTOR_BINARY(ledVectorAdd8, vqaddq_u8)
+LED_VECTOR_BINARY(ledVectorMax8, vmaxq_u8)
+LED_VECTOR_BINARY(ledVectorMin8, vminq_u8)
+#undef LED_VECTOR_BINARY
+
+#else
+// no vector unit -> everything is done by the word loops
+inline size_t ledVectorScale8(uint8_t *, const size_t, const uint16_t) { return 0; }
+inline size_t ledVectorAdd8(uint8_t *, const uint8_t *, const size_t) { return 0; }
+inline size_t ledVectorMax8(uint8_t *, const uint8_t *, const size_t) { return 0; }
+inline size_t ledVectorMin8(uint8_t *, const uint8_t *, const size_t) { return 0; }
+#endif
+
+/**
+ * scale n channels like CRGB::nscale8()
+*/
+inline void bulkScale8(uint8_t *p, size_t n, const uint8_t scale)
+{
+#if FASTLED_SCALE8_FIXED == 1
+  const led_word_t s = (led_word_t)scale + 1;
+#else
+  const led_word_t s = scale;
+#endif
+
+  size_t done = ledVectorScale8(p, n, s);
+  p += done;
+  n -= done;
+
+  for (; n >= sizeof(led_word_t); n -= sizeof(led_word_t), p += sizeof(led_word_t))
+  {
+    led_word_t w = ledLoadWord(p);
+    // every other byte in 16 bit lanes, products fit into their lane
+    led_word_t lo = (((w & LED_WORD_LO) * s) >> 8) & LED_WORD_LO;
+    led_word_t hi = (((w >> 8) & LED_WORD_LO) * s) & ~LED_WORD_LO;
+    ledStoreWord(p, lo | hi);
+  }
+  for (; n > 0; n--, p++)
+  {
+    *p = ((uint16_t)*p * s) >> 8;
+  }
+}
+
+/**
+ * fade n channels towards black like CRGB::fadeToBlackBy()
+*/
+inline void bulkFade8(uint8_t *p, const size_t n, const uint8_t amount)
+{
+  bulkScale8(p, n, 255 - amount);
+}
+
+/**
+ * add src to dst for n channels, saturating at 0xFF like qadd8()
+*/
+inline void bulkAdd8(uint8_t *dst, const uint8_t *src, size_t n)
+{
+  size_t done = ledVectorAdd8(dst, src, n);
+  dst += done;
+  src += done;
+  n -= done;
+
+  for (; n >= sizeof(led_word_t); n -= sizeof(led_word_t), dst += sizeof(led_word_t), src += sizeof(led_word_t))
+  {
+    led_word_t a = ledLoadWord(dst);
+    led_word_t b = ledLoadWord(src);
+    // add lower 7 bits without carry into the next byte, then restore the top bit
+    led_word_t sum = ((a & ~LED_WORD_H) + (b & ~LED_WORD_H)) ^ ((a ^ b) & LED_WORD_H);
+    // bytes that overflowed are set to 0xFF
+    led_word_t carry = ((a & b) | ((a | b) & ~sum)) & LED_WORD_H;
+    ledStoreWord(dst, sum | ((carry >> 7) * 0xFF));
+  }
+  for (; n > 0; n--, dst++, src++)
+  {
+    *dst = qadd8(*dst, *src);
+  }
+}
+
+/**
+ * keep the larger value of dst and src for n channels
+*/
+inline void bulkMax8(uint8_t *dst, const uint8_t *src, size_t n)
+{
+  size_t done = ledVectorMax8(dst, src, n);
+  dst += done;
+  src += done;
+  n -= done;
+
+  for (; n >= sizeof(led_word_t); n -= sizeof(led_word_t), dst += sizeof(led_word_t), src += sizeof(led_word_t))
+  {
+    led_word_t a = ledLoadWord(dst);
+    led_word_t b = ledLoadWord(src);
+    led_word_t m = ledMaskGreaterEqual(a, b);
+    ledStoreWord(dst, (a & m) | (b & ~m));
+  }
+  for (; n > 0; n--, dst++, src++)
+  {
+    if (*src > *dst)
+      *dst = *src;
+  }
+}
+
+/**
+ * keep the smaller value of dst and src for n channels
+*/
+inline void bulkMin8(uint8_t *dst, const uint8_t *src, size_t n)
+{
+  size_t done = ledVectorMin8(dst, src, n);
+  dst += done;
+  src += done;
+  n -= done;
+
+  for (; n >= sizeof(led_word_t); n -= sizeof(led_word_t), dst += sizeof(led_word_t), src += sizeof(led_word_t))
+  {
+    led_word_t a = ledLoadWord(dst);
+    led_word_t b = ledLoadWord(src);
+    led_word_t m = ledMaskGreaterEqual(a, b);
+    ledStoreWord(dst, (b & m) | (a & ~m));
+  }
+  for (; n > 0; n--, dst++, src++)
+  {
+    if (*src < *dst)
+      *dst = *src;
+  }
+}
+
+/**
+ * set n leds to color c, four leds are written as three 32 bit words
+*/
+inline void bulkFill(CRGB *leds, size_t n, const CRGB &c)
+{
+  uint8_t pattern[12];
+  for (uint8_t i = 0; i < 12; i += 3)
+  {
+    pattern[i] = c.r;
+    pattern[i + 1] = c.g;
+    pattern[i + 2] = c.b;
+  }
+
+  uint8_t *p = (uint8_t *)leds;
+  for (; n >= 4; n -= 4, p += 12)
+  {
+    memcpy(p, pattern, 12);
+  }
+  memcpy(p, pattern, n * 3);
+}
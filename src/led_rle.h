@@ -0,0 +1,189 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+/**
+ * run length coding of led colors, used for state snapshots and animation files
+ * every block starts with a control byte c:
+ * - c & 0x80: (c & 0x7F) + 1 copies of the following color
+ * - else: c + 1 colors follow literally
+ * colors are stored as r g b
+ *
+ * sources passed to the decoder provide size_t read(uint8_t *dst, size_t bytes) returning the number of bytes read
+*/
+
+static const uint8_t LED_RLE_MAX_BLOCK = 128;
+
+/**
+ * Fletcher-16 checksum of a byte stream
+*/
+class LED_Checksum
+{
+protected:
+  uint16_t m_a = 0;
+  uint16_t m_b = 0;
+
+public:
+  void add(const uint8_t *p, size_t n)
+  {
+    for (; n > 0; n--, p++)
+    {
+      m_a = (m_a + *p) % 255;
+      m_b = (m_b + m_a) % 255;
+    }
+  }
+
+  inline uint16_t get() const
+  {
+    return (m_b << 8) | m_a;
+  }
+};
+
+/**
+ * Print adapter adding everything written to a checksum
+*/
+class LED_Checksum_Print : public Print
+{
+protected:
+  Print &m_out;
+
+public:
+  LED_Checksum checksum;
+
+  LED_Checksum_Print(Print &out) : m_out(out) {}
+
+  size_t write(uint8_t c) override
+  {
+    return write(&c, 1);
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    size = m_out.write(buffer, size);
+    checksum.add(buffer, size);
+    return size;
+  }
+};
+
+/**
+ * decoder source reading from a Stream and adding everything read to a checksum
+*/
+struct LED_Checksum_Source
+{
+  Stream &in;
+  LED_Checksum checksum;
+
+  LED_Checksum_Source(Stream &in) : in(in) {}
+
+  size_t read(uint8_t *dst, const size_t n)
+  {
+    size_t r = in.readBytes(dst, n);
+    checksum.add(dst, r);
+    return r;
+  }
+};
+
+/**
+ * encode n colors
+ * @param get function object returning color i
+ * @returns number of bytes written
+*/
+template <class GET>
+size_t ledRleEncode(Print &out, const uint16_t n, GET get)
+{
+  size_t bytes = 0;
+  uint16_t i = 0;
+  while (i < n)
+  {
+    // run of identical colors, two are already cheaper than literals
+    uint16_t run = 1;
+    while (i + run < n && run < LED_RLE_MAX_BLOCK && get(i + run) == get(i))
+      run++;
+
+    if (run > 1)
+    {
+      CRGB c = get(i);
+      bytes += out.write((uint8_t)(0x80 | (run - 1)));
+      bytes += out.write((const uint8_t *)&c, 3);
+      i += run;
+      continue;
+    }
+
+    // literals up to the start of the next run
+    uint16_t literal = 1;
+    while (i + literal < n && literal < LED_RLE_MAX_BLOCK && !(i + literal + 1 < n && get(i + literal) == get(i + literal + 1)))
+      literal++;
+
+    bytes += out.write((uint8_t)(literal - 1));
+    for (uint16_t k = 0; k < literal; k++, i++)
+    {
+      CRGB c = get(i);
+      bytes += out.write((const uint8_t *)&c, 3);
+    }
+  }
+  return bytes;
+}
+
+/**
+ * decode n colors block by block, allows copying literals straight from the source
+ * @param run function object called with (index, count, color) for every run
+ * @param literal function object called with (index, count, source), it has to read count colors from source
+ * and return the number of colors read
+ * @returns false if the source ended early or the data is invalid
+*/
+template <class SOURCE, class RUN, class LITERAL>
+bool ledRleDecodeBlocks(SOURCE &in, const uint16_t n, RUN run, LITERAL literal)
+{
+  uint16_t i = 0;
+  while (i < n)
+  {
+    uint8_t c;
+    if (in.read(&c, 1) != 1)
+      return false;
+
+    uint8_t count = (c & 0x7F) + 1;
+    if (count > n - i)
+      return false;
+
+    if (c & 0x80)
+    {
+      CRGB color;
+      if (in.read((uint8_t *)&color, 3) != 3)
+        return false;
+      run(i, count, color);
+    }
+    else if (literal(i, count, in) != count)
+    {
+      return false;
+    }
+    i += count;
+  }
+  return true;
+}
+
+/**
+ * decode n colors
+ * @param put function object called with (index, color) for every color
+ * @returns false if the source ended early or the data is invalid
+*/
+template <class SOURCE, class PUT>
+bool ledRleDecode(SOURCE &in, const uint16_t n, PUT put)
+{
+  return ledRleDecodeBlocks(
+      in, n,
+      [&put](const uint16_t i, const uint8_t count, const CRGB &color) {
+        for (uint8_t k = 0; k < count; k++)
+          put(i + k, color);
+      },
+      [&put](const uint16_t i, const uint8_t count, SOURCE &src) -> uint8_t {
+        CRGB color;
+        for (uint8_t k = 0; k < count; k++)
+        {
+          if (src.read((uint8_t *)&color, 3) != 3)
+            return k;
+          put(i + k, color);
+        }
+        return count;
+      });
+}
@@ -0,0 +1,108 @@
+#ifndef ANIMATION_CLIPS_H
+#define ANIMATION_CLIPS_H
+
+/**
+ * generated test clips for pre-rendered animations, used by the animation tests, the decode benchmark and the encoder tool
+*/
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include <string.h>
+#include <vector>
+
+/**
+ * Print collecting everything written in memory
+*/
+class Buffer_Print : public Print
+{
+public:
+  std::vector<uint8_t> data;
+
+  size_t write(uint8_t c) override
+  {
+    data.push_back(c);
+    return 1;
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    data.insert(data.end(), buffer, buffer + size);
+    return size;
+  }
+};
+
+/**
+ * file of the Arduino FS reading from memory, for LED_Chunked_Source
+*/
+class Memory_File
+{
+protected:
+  const std::vector<uint8_t> &m_data;
+  size_t m_pos = 0;
+
+public:
+  uint32_t reads = 0;
+
+  Memory_File(const std::vector<uint8_t> &data) : m_data(data) {}
+
+  size_t read(uint8_t *buf, size_t size)
+  {
+    reads++;
+    size = min(size, m_data.size() - m_pos);
+    memcpy(buf, m_data.data() + m_pos, size);
+    m_pos += size;
+    return size;
+  }
+
+  bool seek(uint32_t pos)
+  {
+    if (pos > m_data.size())
+      return false;
+    m_pos = pos;
+    return true;
+  }
+};
+
+enum CLIP
+{
+  CLIP_COMET,   // comet with a fading tail moving over a dark strip, few leds change per frame
+  CLIP_TWINKLE, // static gradient with random sparkles
+  CLIP_RAINBOW  // moving rainbow, every led changes in every frame
+};
+
+static const char *const CLIP_NAMES[] = {"comet", "twinkle", "rainbow"};
+static const uint8_t CLIP_COUNT = 3;
+
+/**
+ * write frame of clip into leds, frames of a clip are reproducible
+*/
+inline void clipFrame(const CLIP clip, const uint32_t frame, CRGB *leds, const uint16_t n)
+{
+  switch (clip)
+  {
+  case CLIP_COMET:
+  {
+    const uint16_t head = frame % n;
+    for (uint16_t i = 0; i < n; i++)
+    {
+      uint16_t behind = (head + n - i) % n;
+      leds[i] = behind < 16 ? CRGB(255 - behind * 15, 80 - behind * 5, 0) : CRGB(0, 0, 8);
+    }
+    break;
+  }
+  case CLIP_TWINKLE:
+    for (uint16_t i = 0; i < n; i++)
+    {
+      uint32_t h = (i * 2654435761u) ^ (frame / 4 * 40503u); // sparkles last 4 frames
+      leds[i] = (h >> 24) < 8 ? CRGB(255, 255, 200) : CRGB(i * 255 / n, 20, 255 - i * 255 / n);
+    }
+    break;
+  case CLIP_RAINBOW:
+    for (uint16_t i = 0; i < n; i++)
+      hsv2rgb_rainbow(CHSV(i * 2 + frame * 3, 255, 255), leds[i]);
+    break;
+  }
+}
+
+#endif //ANIMATION_CLIPS_H
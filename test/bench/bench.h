@@ -0,0 +1,137 @@
+#ifndef LED_BENCH_H
+#define LED_BENCH_H
+
+/**
+ * minimal benchmark framework for the host build
+ * every BENCH() registers itself, bench_main.cpp runs them and prints one JSON object per result:
+ * {"bench": "updateLeds/MANY", "pixels": 300, "ns_per_frame": ..., "ns_per_pixel": ..., "fps": ..., "cycles_per_pixel": ...}
+ * cycles are only reported on x86 hosts, they are measured with the time stamp counter
+*/
+
+#include <Arduino.h>
+#include <FastLED.h>
+
+#include <chrono>
+#include <stdio.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LED_BENCH_CYCLES 1
+#else
+#define LED_BENCH_CYCLES 0
+#endif
+
+struct BenchCase
+{
+  const char *name;
+  void (*run)();
+  BenchCase *next;
+};
+
+inline BenchCase *&benchCases()
+{
+  static BenchCase *first = nullptr;
+  return first;
+}
+
+struct BenchRegistrar
+{
+  BenchRegistrar(BenchCase &bench)
+  {
+    BenchCase **last = &benchCases();
+    while (*last)
+      last = &(*last)->next;
+    *last = &bench;
+  }
+};
+
+#define BENCH(name)                                                   \
+  static void bench_##name();                                         \
+  static BenchCase bench_case_##name = {#name, bench_##name, nullptr}; \
+  static BenchRegistrar bench_registrar_##name(bench_case_##name);    \
+  static void bench_##name()
+
+// quick mode runs every benchmark briefly with small sizes, used as a smoke test
+inline bool &benchQuick()
+{
+  static bool quick = false;
+  return quick;
+}
+
+// strip sizes from a single led to large installations
+static const uint16_t BENCH_SIZES[] = {1, 60, 300, 1500, 10000};
+static const uint8_t BENCH_NUM_SIZES = sizeof(BENCH_SIZES) / sizeof(BENCH_SIZES[0]);
+
+inline uint8_t benchNumSizes()
+{
+  return benchQuick() ? 2 : BENCH_NUM_SIZES;
+}
+
+// keep the compiler from removing work whose result is not used
+template <class T>
+inline void benchKeep(const T &value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchTiming
+{
+  double ns;     // per call
+  double cycles; // per call, 0 if not available
+};
+
+/**
+ * call f repeatedly until the minimum run time is reached
+ * @returns average time of one call
+*/
+template <class F>
+BenchTiming benchRun(F f)
+{
+  const double min_ns = benchQuick() ? 1e6 : 2e8;
+
+  f(); // warm up caches and lazily allocated buffers
+
+  uint64_t calls = 0;
+  uint64_t batch = 1;
+  double ns = 0;
+  uint64_t cycles = 0;
+  while (ns < min_ns)
+  {
+#if LED_BENCH_CYCLES
+    uint64_t c0 = __rdtsc();
+#endif
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < batch; i++)
+      f();
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+#if LED_BENCH_CYCLES
+    cycles += __rdtsc() - c0;
+#endif
+    calls += batch;
+    batch *= 2;
+  }
+  return {ns / calls, (double)cycles / calls};
+}
+
+/**
+ * print one result as JSON
+ * @param pixels number of pixels processed per call, frames per second are reported per call
+*/
+inline void benchReport(const char *name, const uint32_t pixels, const BenchTiming &t)
+{
+  printf("{\"bench\": \"%s\", \"pixels\": %u, \"ns_per_frame\": %.1f, \"ns_per_pixel\": %.3f, \"fps\": %.1f",
+         name, pixels, t.ns, t.ns / pixels, 1e9 / t.ns);
+#if LED_BENCH_CYCLES
+  printf(", \"cycles_per_pixel\": %.2f", t.cycles / pixels);
+#endif
+  printf("}\n");
+  fflush(stdout);
+}
+
+template <class F>
+inline void bench(const char *name, const uint32_t pixels, F f)
+{
+  benchReport(name, pixels, benchRun(f));
+}
+
+#endif //LED_BENCH_H
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "../host_strip.h"
+#include "../animation_clips.h"
+
+#include <LED_Animation.h>
+
+#include <string>
+
+// decode throughput of pre-rendered animations, fps is frames decoded per second
+BENCH(animation)
+{
+  const uint16_t n = 1000;
+  const uint32_t frames = benchQuick() ? 20 : 300;
+  std::vector<CRGB> frame(n);
+
+  for (uint8_t c = 0; c < CLIP_COUNT; c++)
+  {
+    Buffer_Print file;
+    LED_Animation_Encoder enc(file, n, 40, 100);
+    for (uint32_t f = 0; f < frames; f++)
+    {
+      clipFrame((CLIP)c, f, frame.data(), n);
+      enc.addFrame(frame.data());
+    }
+
+    Host_Strip s(n);
+    s.begin();
+
+    LED_Memory_Source memory(file.data.data(), file.data.size());
+    LED_Animation_Player<LED_Memory_Source> from_memory(memory);
+    from_memory.begin();
+    bench(("animation/decode_" + std::string(CLIP_NAMES[c])).c_str(), n, [&]() {
+      from_memory.step(s);
+    });
+
+    // file system reads in 64 byte chunks
+    Memory_File fs(file.data);
+    LED_Chunked_Source<Memory_File> chunked(fs);
+    LED_Animation_Player<LED_Chunked_Source<Memory_File>> from_file(chunked);
+    from_file.begin();
+    bench(("animation/decode_" + std::string(CLIP_NAMES[c]) + "_chunked").c_str(), n, [&]() {
+      from_file.step(s);
+    });
+
+    // decode and render the output buffer
+    bench(("animation/play_" + std::string(CLIP_NAMES[c])).c_str(), n, [&]() {
+      from_memory.step(s);
+      s.render();
+    });
+  }
+}
@@ -0,0 +1,35 @@
+#include "bench.h"
+
+#include <CRGB_d.h>
+#include <CRGB_q.h>
+
+// fixed point CRGB_q compared to the double precision CRGB_d it replaces
+template <class COLOR>
+static void benchColor(const char *set_hsb, const char *set_xy, const char *scale)
+{
+  COLOR c;
+  int hue = 0;
+  bench(set_hsb, 1, [&]() {
+    hue = (hue + 97) & 0xFFFF;
+    c.setHSB(hue, 200, 180);
+    benchKeep(c);
+  });
+  float x = 0.1f;
+  bench(set_xy, 1, [&]() {
+    x = x > 0.6f ? 0.1f : x + 0.001f;
+    c.setXY(x, 0.7f - x, 200);
+    benchKeep(c);
+  });
+  c.setRGB(200, 100, 50);
+  bench(scale, 1, [&]() {
+    c *= 0.999;
+    c += COLOR(0.2, 0.1, 0.05);
+    benchKeep(c);
+  });
+}
+
+BENCH(CRGB_q)
+{
+  benchColor<CRGB_d>("CRGB_d/setHSB", "CRGB_d/setXY", "CRGB_d/scale_add");
+  benchColor<CRGB_q>("CRGB_q/setHSB", "CRGB_q/setXY", "CRGB_q/scale_add");
+}
@@ -0,0 +1,43 @@
+#include "bench.h"
+#include "../host_strip.h"
+
+#include <vector>
+
+// 8 bit lookup compared to 16 bit lookup with temporal dithering
+BENCH(dither)
+{
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+    std::vector<CRGB> in(n), out(n);
+    std::vector<uint8_t> err(n * 3);
+    for (uint16_t i = 0; i < n; i++)
+      in[i] = CRGB(i, i * 3, i * 7);
+
+    ScaledColorTable table8;
+    table8.update(40, CRGB(255, 176, 240));
+    bench("dither/table8", n, [&]() {
+      for (uint16_t i = 0; i < n; i++)
+        out[i] = table8.scale(in[i]);
+      benchKeep(out[0]);
+    });
+
+    DitheredColorTable table16;
+    table16.update(40, CRGB(255, 176, 240));
+    bench("dither/table16", n, [&]() {
+      for (uint16_t i = 0; i < n; i++)
+        out[i] = table16.dither(in[i], &err[i * 3]);
+      benchKeep(out[0]);
+    });
+
+    // dithered strips render every led in every frame
+    Host_Strip s(n);
+    s.begin(CRGB::Black, 40);
+    for (uint16_t i = 0; i < n; i++)
+      s.setSingleColor(in[i], i);
+    s.setDither(true);
+    bench("dither/updateLeds_MANY", n, [&]() {
+      s.render();
+    });
+  }
+}
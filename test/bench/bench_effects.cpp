@@ -0,0 +1,61 @@
+#include "bench.h"
+#include "../host_strip.h"
+
+#include <LED_Effects.h>
+
+// one step of each built in effect plus rendering the result
+BENCH(effects)
+{
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+    Host_Strip s(n);
+    s.begin();
+
+    bench("effect/sparkle", n, [&]() {
+      s.sparkle();
+      s.render();
+    });
+    bench("effect/sectionColor", n, [&]() {
+      s.sectionColor(10);
+      s.render();
+    });
+    bench("effect/spectrumHue", n, [&]() {
+      s.spectrumHue();
+      s.render();
+    });
+    bench("effect/movingPoint", n, [&]() {
+      s.movingPoint(CRGB::Red);
+      s.render();
+    });
+    bench("effect/movingHue", n, [&]() {
+      s.movingHue();
+      s.render();
+    });
+  }
+}
+
+// runtime selected effect of the engine, the host clock advances by one interval per frame
+BENCH(effectEngine)
+{
+  static const char *NAMES[] = {"effectEngine/sparkle", "effectEngine/sectionColor", "effectEngine/spectrumHue",
+                                "effectEngine/movingPoint", "effectEngine/movingHue"};
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+    Host_Strip s(n);
+    s.begin();
+
+    LED_Effect_Engine<Sparkle_Effect, SectionColor_Effect, SpectrumHue_Effect, MovingPoint_Effect, MovingHue_Effect> engine;
+    engine.get<SectionColor_Effect>().setSectionSize(10);
+    for (uint8_t id = 0; id < engine.NUM_EFFECTS; id++)
+    {
+      engine.select(id);
+      bench(NAMES[id], n, [&]() {
+        hostAdvanceMillis(20);
+        engine.render(s);
+        s.render();
+      });
+    }
+  }
+}
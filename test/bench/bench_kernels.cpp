@@ -0,0 +1,67 @@
+#include "bench.h"
+
+#include <led_kernels.h>
+
+#include <vector>
+
+// bulk kernels compared to the per led FastLED functions they replace
+BENCH(kernels)
+{
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+    std::vector<CRGB> dst(n), src(n);
+    for (uint16_t i = 0; i < n; i++)
+    {
+      dst[i] = CRGB(i, i * 3, i * 7);
+      src[i] = CRGB(i * 5, i * 11, i * 13);
+    }
+    uint8_t *d = (uint8_t *)dst.data();
+    const uint8_t *s = (const uint8_t *)src.data();
+
+    bench("kernels/nscale8", n, [&]() {
+      for (uint16_t i = 0; i < n; i++)
+        dst[i].nscale8(250);
+      benchKeep(dst[0]);
+    });
+    bench("kernels/bulkScale8", n, [&]() {
+      bulkScale8(d, n * 3, 250);
+      benchKeep(dst[0]);
+    });
+
+    bench("kernels/qadd8", n, [&]() {
+      for (uint16_t i = 0; i < n * 3; i++)
+        d[i] = qadd8(d[i], s[i]);
+      benchKeep(dst[0]);
+    });
+    bench("kernels/bulkAdd8", n, [&]() {
+      bulkAdd8(d, s, n * 3);
+      benchKeep(dst[0]);
+    });
+
+    bench("kernels/max", n, [&]() {
+      for (uint16_t i = 0; i < n * 3; i++)
+        if (s[i] > d[i])
+          d[i] = s[i];
+      benchKeep(dst[0]);
+    });
+    bench("kernels/bulkMax8", n, [&]() {
+      bulkMax8(d, s, n * 3);
+      benchKeep(dst[0]);
+    });
+    bench("kernels/bulkMin8", n, [&]() {
+      bulkMin8(d, s, n * 3);
+      benchKeep(dst[0]);
+    });
+
+    bench("kernels/fill", n, [&]() {
+      for (uint16_t i = 0; i < n; i++)
+        dst[i] = CRGB(1, 2, 3);
+      benchKeep(dst[0]);
+    });
+    bench("kernels/bulkFill", n, [&]() {
+      bulkFill(dst.data(), n, CRGB(1, 2, 3));
+      benchKeep(dst[0]);
+    });
+  }
+}
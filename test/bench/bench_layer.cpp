@@ -0,0 +1,97 @@
+#include "bench.h"
+#include "../host_strip.h"
+
+#include <LED_Layer.h>
+
+// 4 layer compositor: background hue, additive sparkles, multiply filter and a flash
+BENCH(layers)
+{
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+    Host_Strip s(n);
+    s.begin();
+    LED_Layer bg(n), sparkle(n), filter(n), flash(n);
+    LED_Compositor<> c(s);
+    c.add(bg);
+    c.add(sparkle);
+    c.add(filter);
+    c.add(flash);
+    sparkle.setBlend(LED_Layer::ADD);
+    filter.setBlend(LED_Layer::MULTIPLY);
+    filter.setRangeColor(CRGB(255, 128, 255), 0, n);
+    flash.setRangeColor(CRGB::White, n / 10, n / 20 + 1);
+
+    SpectrumHue_Effect hue;
+    Sparkle_Effect sparkles;
+    for (uint16_t i = 0; i < n; i++)
+      hue.step(bg);
+    c.compose();
+
+    uint8_t opacity = 0;
+    bench("layers/compose_all_changed", n, [&]() {
+      hue.step(bg);
+      sparkles.step(sparkle);
+      flash.setOpacity(opacity++);
+      c.compose();
+      s.render();
+    });
+
+    // background static, only the sparkle layer changes
+    bench("layers/compose_sparkle", n, [&]() {
+      sparkles.step(sparkle);
+      c.compose();
+      s.render();
+    });
+
+    // one led of one layer changes
+    uint16_t i = 0;
+    bench("layers/compose_one_led", n, [&]() {
+      flash.setSingleColor(CRGB(i, 255, 255), i % n);
+      i++;
+      c.compose();
+      s.render();
+    });
+  }
+}
+
+/**
+ * 4 layers on 1000 leds with every layer changing in every frame must fit into 5 ms including the render,
+ * the flash opacity changes every frame so blending takes the per channel path
+*/
+BENCH(layers_budget)
+{
+  const uint16_t n = 1000;
+  const double budget_ns = 5e6;
+  Host_Strip s(n);
+  s.begin();
+  LED_Layer bg(n), sparkle(n), filter(n), flash(n);
+  LED_Compositor<> c(s);
+  c.add(bg);
+  c.add(sparkle);
+  c.add(filter);
+  c.add(flash);
+  sparkle.setBlend(LED_Layer::ADD);
+  filter.setBlend(LED_Layer::MULTIPLY);
+  filter.setRangeColor(CRGB(255, 128, 255), 0, n);
+  flash.setRangeColor(CRGB::White, 100, 50);
+
+  SpectrumHue_Effect hue;
+  Sparkle_Effect sparkles;
+  for (uint16_t i = 0; i < n; i++)
+    hue.step(bg);
+
+  uint16_t f = 0;
+  BenchTiming t = benchRun([&]() {
+    hue.step(bg);
+    sparkles.step(sparkle);
+    filter.setSingleColor(CRGB(255, f, 255), f % n);
+    flash.setOpacity(f++);
+    c.compose();
+    s.render();
+  });
+  benchReport("layers/budget_1000", n, t);
+  printf("{\"bench\": \"layers/budget_1000\", \"budget_ns\": %.0f, \"within_budget\": %s}\n",
+         budget_ns, t.ns < budget_ns ? "true" : "false");
+  fflush(stdout);
+}
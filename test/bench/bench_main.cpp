@@ -0,0 +1,27 @@
+#include "bench.h"
+
+#include <string.h>
+
+/**
+ * usage: led_bench [--quick] [filter]
+ * runs all benchmarks or only those whose name contains filter
+*/
+int main(int argc, char **argv)
+{
+  const char *filter = nullptr;
+  for (int i = 1; i < argc; i++)
+  {
+    if (strcmp(argv[i], "--quick") == 0)
+      benchQuick() = true;
+    else
+      filter = argv[i];
+  }
+
+  for (BenchCase *b = benchCases(); b; b = b->next)
+  {
+    if (filter && !strstr(b->name, filter))
+      continue;
+    b->run();
+  }
+  return 0;
+}
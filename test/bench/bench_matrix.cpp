@@ -0,0 +1,86 @@
+#include "bench.h"
+#include "../host_strip.h"
+#include "../matrix_naive.h"
+
+#include <LED_Matrix.h>
+
+// full frame of a 2D effect, scrolling it by one pixel and updating one row
+BENCH(matrix)
+{
+  // 16x16 panel, 2x2 and 4x2 panels
+  const uint8_t layouts[][2] = {{1, 1}, {2, 2}, {4, 2}};
+  const uint8_t num = benchQuick() ? 2 : 3;
+  for (uint8_t k = 0; k < num; k++)
+  {
+    // layout is configured at run time, keep the compiler from folding it into the naive mapping
+    int tw = 16, th = 16, tiles_x = layouts[k][0], tiles_y = layouts[k][1], rotation = 0;
+    bool serpentine = true;
+    asm volatile("" : "+r"(tw), "+r"(th), "+r"(tiles_x), "+r"(rotation), "+r"(serpentine));
+    const uint8_t w = tw * tiles_x, h = th * tiles_y;
+    const uint16_t n = w * h;
+
+    Host_Strip naive(n);
+    naive.begin();
+    uint8_t t = 0;
+    bench("matrix/frame_naive", n, [&]() {
+      t++;
+      for (uint8_t y = 0; y < h; y++)
+        for (uint8_t x = 0; x < w; x++)
+          naive.setSingleColor(CRGB(x * 8 + t, y * 8, t), naiveMatrixIndex(x, y, tw, th, tiles_x, serpentine, rotation));
+      naive.render();
+    });
+
+    Host_Strip s(n);
+    s.begin();
+    LED_Matrix m(s, tw, th, tiles_x, tiles_y, serpentine, (LED_Matrix::ROTATION)rotation);
+    bench("matrix/frame_setPixel", n, [&]() {
+      t++;
+      for (uint8_t y = 0; y < h; y++)
+        for (uint8_t x = 0; x < w; x++)
+          m.setPixel(x, y, CRGB(x * 8 + t, y * 8, t));
+      s.render();
+    });
+
+    CRGB row[255];
+    bench("matrix/frame_setRow", n, [&]() {
+      t++;
+      for (uint8_t y = 0; y < h; y++)
+      {
+        for (uint8_t x = 0; x < w; x++)
+          row[x] = CRGB(x * 8 + t, y * 8, t);
+        m.setRow(y, row);
+      }
+      s.render();
+    });
+
+    // scrolling without the matrix moves every pixel
+    std::vector<CRGB> image(n);
+    bench("matrix/scroll_naive", n, [&]() {
+      for (uint8_t y = 0; y < h; y++)
+      {
+        CRGB last = image[y * w + w - 1];
+        memmove(&image[y * w + 1], &image[y * w], (w - 1) * sizeof(CRGB));
+        image[y * w] = last;
+        for (uint8_t x = 0; x < w; x++)
+          naive.setSingleColor(image[y * w + x], naiveMatrixIndex(x, y, tw, th, tiles_x, serpentine, rotation));
+      }
+      naive.render();
+    });
+
+    bench("matrix/scroll", n, [&]() {
+      m.scroll(1, 0);
+      s.render();
+    });
+
+    // scroll and draw the new column like a text ticker
+    CRGB column[255];
+    bench("matrix/ticker", n, [&]() {
+      t++;
+      m.scroll(-1, 0);
+      for (uint8_t y = 0; y < h; y++)
+        column[y] = CRGB(t, y, 0);
+      m.setColumn(w - 1, column);
+      s.render();
+    });
+  }
+}
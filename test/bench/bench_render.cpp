@@ -0,0 +1,69 @@
+#include "bench.h"
+#include "../host_strip.h"
+
+#include <vector>
+
+BENCH(updateLeds)
+{
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+
+    Host_Strip single(n);
+    single.begin();
+    bool toggle = false;
+    bench("updateLeds/SINGLE", n, [&]() {
+      toggle = !toggle;
+      single.setColor(toggle ? CRGB(200, 10, 3) : CRGB(3, 10, 200));
+      single.render();
+    });
+
+    Host_Strip many(n);
+    many.begin();
+    for (uint16_t i = 0; i < n; i++)
+      many.setSingleColor(CRGB(i, i >> 1, 255 - i), i);
+    bench("updateLeds/MANY", n, [&]() {
+      many.forceUpdate(); // every led changed
+      many.render();
+    });
+
+    bench("updateLeds/MANY_unchanged", n, [&]() {
+      many.render();
+    });
+  }
+}
+
+BENCH(scaledColor)
+{
+  for (uint8_t k = 0; k < benchNumSizes(); k++)
+  {
+    const uint16_t n = BENCH_SIZES[k];
+    std::vector<CRGB> in(n), out(n);
+    for (uint16_t i = 0; i < n; i++)
+      in[i] = CRGB(i, i * 3, i * 7);
+
+    uint8_t bri = 0;
+    bench("scaledColor", n, [&]() {
+      bri++;
+      for (uint16_t i = 0; i < n; i++)
+        out[i] = scaledColor(in[i], bri, CRGB(255, 176, 240));
+      benchKeep(out[0]);
+    });
+  }
+}
+
+BENCH(ledLinBrightness)
+{
+  uint8_t values[256];
+  bench("ledLinBrightness", 256, [&]() {
+    for (uint16_t x = 0; x < 256; x++)
+      values[x] = ledLinBrightness(x);
+    benchKeep(values);
+  });
+  uint16_t values10[1024];
+  bench("ledLinBrightness_10bit", 1024, [&]() {
+    for (uint16_t x = 0; x < 1024; x++)
+      values10[x] = ledLinBrightness_10bit(x);
+    benchKeep(values10);
+  });
+}
@@ -0,0 +1,40 @@
+#include "bench.h"
+
+#include <led_helper.h>
+
+#include <vector>
+
+// per pixel scaledColor() compared to the fused lookup table used by the render loop
+BENCH(scaledColorTable)
+{
+  static const uint16_t SIZES[] = {60, 300, 1500};
+  for (uint16_t n : SIZES)
+  {
+    std::vector<CRGB> in(n), out(n);
+    for (uint16_t i = 0; i < n; i++)
+      in[i] = CRGB(i, i * 3, i * 7);
+
+    bench("scaledColor/per_pixel", n, [&]() {
+      for (uint16_t i = 0; i < n; i++)
+        out[i] = scaledColor(in[i], 180, CRGB(255, 176, 240));
+      benchKeep(out[0]);
+    });
+
+    ScaledColorTable table;
+    table.update(180, CRGB(255, 176, 240));
+    bench("scaledColor/table", n, [&]() {
+      for (uint16_t i = 0; i < n; i++)
+        out[i] = table.scale(in[i]);
+      benchKeep(out[0]);
+    });
+
+    // brightness changes every frame, the table is rebuilt once per frame
+    uint8_t bri = 0;
+    bench("scaledColor/table_rebuilt", n, [&]() {
+      table.update(++bri, CRGB(255, 176, 240));
+      for (uint16_t i = 0; i < n; i++)
+        out[i] = table.scale(in[i]);
+      benchKeep(out[0]);
+    });
+  }
+}
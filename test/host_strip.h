@@ -0,0 +1,45 @@
+#ifndef HOST_STRIP_H
+#define HOST_STRIP_H
+
+#include <Adressable_LED_Strip.h>
+
+/**
+ * adressable strip without hardware for host tests and benchmarks
+ * show() only counts frames, the output buffer can be read directly
+*/
+class Host_Strip : public Adressable_LED_Strip
+{
+public:
+  uint32_t shows = 0;
+
+  Host_Strip(const int p_nleds) : Adressable_LED_Strip(p_nleds) {}
+
+  void show() override
+  {
+    shows++;
+  }
+
+  // output led i as it would be sent to the hardware
+  inline CRGB out(const uint16_t i)
+  {
+    return m_leds[i];
+  }
+
+  inline const CRGB *outputBuffer()
+  {
+    return m_leds;
+  }
+
+  /**
+   * power on at full brightness without transitions
+  */
+  Host_Strip &begin(const CRGB &color = CRGB::Black, const uint8_t brightness = 255)
+  {
+    init(color, brightness, 0);
+    setBrightness(brightness);
+    setPower(brightness > 0);
+    return *this;
+  }
+};
+
+#endif //HOST_STRIP_H
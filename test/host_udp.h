@@ -0,0 +1,128 @@
+#ifndef HOST_UDP_H
+#define HOST_UDP_H
+
+/**
+ * UDP socket with the subset of the Arduino WiFiUDP interface used by LED_Stream_Receiver
+ * bound to the loopback interface by default, used by the host tests and the replay tool
+*/
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+class Host_UDP
+{
+protected:
+  static const size_t MAX_PACKET = 1500;
+
+  int m_fd = -1;
+  uint8_t m_packet[MAX_PACKET];
+  size_t m_size = 0; // bytes of the current packet
+  size_t m_pos = 0;  // bytes already read
+
+public:
+  ~Host_UDP()
+  {
+    stop();
+  }
+
+  /**
+   * open socket and bind it to port, 0 picks a free port
+   * @returns 1 on success like WiFiUDP::begin()
+  */
+  uint8_t begin(const uint16_t port, const char *address = "127.0.0.1")
+  {
+    stop();
+    m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (m_fd < 0)
+      return 0;
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address, &addr.sin_addr) != 1 || bind(m_fd, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+      stop();
+      return 0;
+    }
+    return 1;
+  }
+
+  void stop()
+  {
+    if (m_fd >= 0)
+      close(m_fd);
+    m_fd = -1;
+    m_size = m_pos = 0;
+  }
+
+  // port the socket is bound to
+  uint16_t localPort()
+  {
+    sockaddr_in addr = {};
+    socklen_t len = sizeof(addr);
+    if (m_fd < 0 || getsockname(m_fd, (sockaddr *)&addr, &len) != 0)
+      return 0;
+    return ntohs(addr.sin_port);
+  }
+
+  /**
+   * receive the next packet without blocking, unread bytes of the previous packet are dropped
+   * @returns size of the packet, 0 if none is pending
+  */
+  int parsePacket()
+  {
+    m_size = m_pos = 0;
+    if (m_fd < 0)
+      return 0;
+    ssize_t r = recv(m_fd, m_packet, sizeof(m_packet), MSG_DONTWAIT);
+    if (r <= 0)
+      return 0;
+    m_size = r;
+    return r;
+  }
+
+  int available()
+  {
+    return m_size - m_pos;
+  }
+
+  int read(uint8_t *buf, size_t len)
+  {
+    if (len > m_size - m_pos)
+      len = m_size - m_pos;
+    memcpy(buf, m_packet + m_pos, len);
+    m_pos += len;
+    return len;
+  }
+
+  /**
+   * send one packet to host:port, the socket is opened on first use if begin() was not called
+   * @returns true if the whole packet has been sent
+  */
+  bool send(const char *host, const uint16_t port, const uint8_t *data, const size_t len)
+  {
+    if (m_fd < 0 && !begin(0, "0.0.0.0"))
+      return false;
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo *res = nullptr;
+    char service[8];
+    snprintf(service, sizeof(service), "%u", port);
+    if (getaddrinfo(host, service, &hints, &res) != 0)
+      return false;
+    ssize_t r = sendto(m_fd, data, len, 0, res->ai_addr, res->ai_addrlen);
+    freeaddrinfo(res);
+    return r == (ssize_t)len;
+  }
+};
+
+#endif //HOST_UDP_H
@@ -0,0 +1,38 @@
+#ifndef MATRIX_NAIVE_H
+#define MATRIX_NAIVE_H
+
+/**
+ * output led of pixel x, y of chained matrix panels computed per pixel, the way 2D effects mapped pixels before LED_Matrix
+ * used as reference by the matrix tests and as baseline by the matrix benchmark
+ * @param rotation 0 - 3 like LED_Matrix::ROTATION
+*/
+inline uint16_t naiveMatrixIndex(const int x, const int y, const int tw, const int th, const int tiles_x, const bool serpentine, const int rotation)
+{
+  int tx = x / tw, ty = y / th, lx = x % tw, ly = y % th;
+  int r, c;
+  switch (rotation)
+  {
+  case 1:
+    r = tw - 1 - lx;
+    c = ly;
+    break;
+  case 2:
+    c = tw - 1 - lx;
+    r = th - 1 - ly;
+    break;
+  case 3:
+    r = lx;
+    c = th - 1 - ly;
+    break;
+  default:
+    r = ly;
+    c = lx;
+    break;
+  }
+  int wire_cols = rotation == 1 || rotation == 3 ? th : tw;
+  if (serpentine && (r & 1))
+    c = wire_cols - 1 - c;
+  return (ty * tiles_x + tx) * tw * th + r * wire_cols + c;
+}
+
+#endif //MATRIX_NAIVE_H
@@ -0,0 +1,227 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+/**
+ * minimal Arduino core for building the library on a host
+ * time does not run by itself, tests advance it with hostAdvanceMillis() / hostAdvanceMicros()
+ * so results do not depend on the speed of the machine
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+
+using std::max;
+using std::min;
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// time
+
+inline uint32_t &hostMicros()
+{
+  static uint32_t t = 0;
+  return t;
+}
+
+inline unsigned long micros()
+{
+  return hostMicros();
+}
+
+inline unsigned long millis()
+{
+  return hostMicros() / 1000;
+}
+
+inline void hostAdvanceMicros(const uint32_t us)
+{
+  hostMicros() += us;
+}
+
+inline void hostAdvanceMillis(const uint32_t ms)
+{
+  hostMicros() += ms * 1000;
+}
+
+inline void hostSetMillis(const uint32_t ms)
+{
+  hostMicros() = ms * 1000;
+}
+
+inline void delay(const unsigned long ms)
+{
+  hostAdvanceMillis(ms);
+}
+
+inline void yield() {}
+
+// pwm, every write is recorded so tests can count and verify them
+
+struct HostPwm
+{
+  static const uint8_t PINS = 32;
+
+  int32_t value[PINS];  // last value written per pin, -1 if never written
+  uint32_t writes = 0;  // number of analogWrite() calls
+  uint32_t range = 255; // set by analogWriteRange()
+  uint32_t frequency = 1000;
+
+  HostPwm()
+  {
+    reset();
+  }
+
+  void reset()
+  {
+    for (uint8_t i = 0; i < PINS; i++)
+      value[i] = -1;
+    writes = 0;
+  }
+};
+
+inline HostPwm &hostPwm()
+{
+  static HostPwm pwm;
+  return pwm;
+}
+
+inline void analogWrite(const uint8_t pin, const int value)
+{
+  HostPwm &pwm = hostPwm();
+  if (pin < HostPwm::PINS)
+    pwm.value[pin] = value;
+  pwm.writes++;
+}
+
+inline void analogWriteRange(const uint32_t range)
+{
+  hostPwm().range = range;
+}
+
+inline void analogWriteFreq(const uint32_t frequency)
+{
+  hostPwm().frequency = frequency;
+}
+
+// print and stream
+
+class Print;
+
+class Printable
+{
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+      n += write(*buffer++);
+    return n;
+  }
+
+  size_t print(const char *s)
+  {
+    return write((const uint8_t *)s, strlen(s));
+  }
+
+  size_t print(const char c)
+  {
+    return write((uint8_t)c);
+  }
+
+  size_t print(const double d)
+  {
+    char b[32];
+    snprintf(b, sizeof(b), "%.2f", d);
+    return print(b);
+  }
+
+  size_t print(const unsigned long d)
+  {
+    char b[32];
+    snprintf(b, sizeof(b), "%lu", d);
+    return print(b);
+  }
+
+  size_t print(const long d)
+  {
+    char b[32];
+    snprintf(b, sizeof(b), "%ld", d);
+    return print(b);
+  }
+
+  size_t print(const unsigned int d)
+  {
+    return print((unsigned long)d);
+  }
+
+  size_t print(const int d)
+  {
+    return print((long)d);
+  }
+
+  size_t print(const uint8_t d)
+  {
+    return print((unsigned long)d);
+  }
+
+  size_t print(const uint16_t d)
+  {
+    return print((unsigned long)d);
+  }
+
+  size_t print(const Printable &x)
+  {
+    return x.printTo(*this);
+  }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+
+  virtual int peek()
+  {
+    return -1;
+  }
+
+  size_t readBytes(uint8_t *buffer, size_t length)
+  {
+    size_t i = 0;
+    for (; i < length; i++)
+    {
+      int c = read();
+      if (c < 0)
+        break;
+      buffer[i] = c;
+    }
+    return i;
+  }
+
+  size_t readBytes(char *buffer, size_t length)
+  {
+    return readBytes((uint8_t *)buffer, length);
+  }
+};
+
+#endif //ARDUINO_H
@@ -0,0 +1,388 @@
+#ifndef FASTLED_H
+#define FASTLED_H
+
+/**
+ * subset of FastLED used by the library, for building on a host
+ * the math functions match FastLED with FASTLED_SCALE8_FIXED, colors converted from CHSV are close but not identical
+ * CLEDController is a mock recording what would have been sent to the strip
+*/
+
+#include <Arduino.h>
+#include <vector>
+
+#ifndef FASTLED_SCALE8_FIXED
+#define FASTLED_SCALE8_FIXED 1
+#endif
+
+typedef uint8_t fract8;
+
+inline uint8_t scale8(const uint8_t i, const fract8 scale)
+{
+  return ((uint16_t)i * (1 + (uint16_t)scale)) >> 8;
+}
+
+inline uint8_t scale8_video(const uint8_t i, const fract8 scale)
+{
+  return (((uint16_t)i * scale) >> 8) + ((i && scale) ? 1 : 0);
+}
+
+inline uint8_t qadd8(const uint8_t i, const uint8_t j)
+{
+  uint16_t t = i + j;
+  return t > 255 ? 255 : t;
+}
+
+inline uint8_t qsub8(const uint8_t i, const uint8_t j)
+{
+  return i > j ? i - j : 0;
+}
+
+// deterministic generator, tests can reset it with random16_set_seed()
+inline uint16_t &hostRandomSeed()
+{
+  static uint16_t seed = 1337;
+  return seed;
+}
+
+inline void random16_set_seed(const uint16_t seed)
+{
+  hostRandomSeed() = seed;
+}
+
+inline uint16_t random16()
+{
+  hostRandomSeed() = hostRandomSeed() * 2053 + 13849; // same generator as FastLED
+  return hostRandomSeed();
+}
+
+inline uint8_t random8()
+{
+  uint16_t r = random16();
+  return (uint8_t)r + (uint8_t)(r >> 8);
+}
+
+inline uint8_t random8(const uint8_t lim)
+{
+  return (random8() * lim) >> 8;
+}
+
+inline uint8_t random8(const uint8_t min, const uint8_t lim)
+{
+  return random8(lim - min) + min;
+}
+
+enum EOrder
+{
+  RGB = 0012,
+  RBG = 0021,
+  GRB = 0102,
+  GBR = 0120,
+  BRG = 0201,
+  BGR = 0210
+};
+
+enum LEDColorCorrection
+{
+  TypicalSMD5050 = 0xFFB0F0,
+  TypicalLEDStrip = 0xFFB0F0,
+  Typical8mmPixel = 0xFFE08C,
+  TypicalPixelString = 0xFFE08C,
+  UncorrectedColor = 0xFFFFFF
+};
+
+enum ColorTemperature
+{
+  Candle = 0xFF9329,
+  Tungsten40W = 0xFFC58F,
+  Tungsten100W = 0xFFD6AA,
+  Halogen = 0xFFF1E0,
+  CarbonArc = 0xFFFAF4,
+  HighNoonSun = 0xFFFFFB,
+  DirectSunlight = 0xFFFFFF,
+  OvercastSky = 0xC9E2FF,
+  ClearBlueSky = 0x409CFF,
+  UncorrectedTemperature = 0xFFFFFF
+};
+
+struct CHSV
+{
+  union {
+    struct
+    {
+      uint8_t h;
+      uint8_t s;
+      uint8_t v;
+    };
+    uint8_t raw[3];
+  };
+
+  CHSV() {}
+  CHSV(const uint8_t ih, const uint8_t is, const uint8_t iv) : h(ih), s(is), v(iv) {}
+};
+
+struct CRGB;
+inline void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb);
+
+struct CRGB
+{
+  union {
+    struct
+    {
+      union {
+        uint8_t r;
+        uint8_t red;
+      };
+      union {
+        uint8_t g;
+        uint8_t green;
+      };
+      union {
+        uint8_t b;
+        uint8_t blue;
+      };
+    };
+    uint8_t raw[3];
+  };
+
+  enum HTMLColorCode
+  {
+    Black = 0x000000,
+    Blue = 0x0000FF,
+    Green = 0x008000,
+    Red = 0xFF0000,
+    White = 0xFFFFFF
+  };
+
+  inline uint8_t &operator[](const uint8_t x)
+  {
+    return raw[x];
+  }
+
+  inline const uint8_t &operator[](const uint8_t x) const
+  {
+    return raw[x];
+  }
+
+  CRGB() {}
+  CRGB(const uint8_t ir, const uint8_t ig, const uint8_t ib) : r(ir), g(ig), b(ib) {}
+  CRGB(const uint32_t colorcode) : r(colorcode >> 16), g(colorcode >> 8), b(colorcode) {}
+  CRGB(const HTMLColorCode colorcode) : CRGB((uint32_t)colorcode) {}
+  CRGB(const LEDColorCorrection colorcode) : CRGB((uint32_t)colorcode) {}
+  CRGB(const ColorTemperature colorcode) : CRGB((uint32_t)colorcode) {}
+
+  CRGB(const CHSV &rhs)
+  {
+    hsv2rgb_rainbow(rhs, *this);
+  }
+
+  inline CRGB &operator=(const uint32_t colorcode)
+  {
+    r = colorcode >> 16;
+    g = colorcode >> 8;
+    b = colorcode;
+    return *this;
+  }
+
+  inline CRGB &nscale8(const uint8_t scaledown)
+  {
+    r = scale8(r, scaledown);
+    g = scale8(g, scaledown);
+    b = scale8(b, scaledown);
+    return *this;
+  }
+
+  inline CRGB &nscale8(const CRGB &scaledown)
+  {
+    r = scale8(r, scaledown.r);
+    g = scale8(g, scaledown.g);
+    b = scale8(b, scaledown.b);
+    return *this;
+  }
+
+  inline CRGB &fadeToBlackBy(const uint8_t fadefactor)
+  {
+    return nscale8(255 - fadefactor);
+  }
+
+  inline CRGB &operator+=(const CRGB &rhs)
+  {
+    r = qadd8(r, rhs.r);
+    g = qadd8(g, rhs.g);
+    b = qadd8(b, rhs.b);
+    return *this;
+  }
+
+  inline CRGB &operator|=(const CRGB &rhs)
+  {
+    r = max(r, rhs.r);
+    g = max(g, rhs.g);
+    b = max(b, rhs.b);
+    return *this;
+  }
+
+  inline explicit operator bool() const
+  {
+    return r || g || b;
+  }
+};
+
+inline bool operator==(const CRGB &lhs, const CRGB &rhs)
+{
+  return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b;
+}
+
+inline bool operator!=(const CRGB &lhs, const CRGB &rhs)
+{
+  return !(lhs == rhs);
+}
+
+// six equal hue sectors, FastLED stretches yellow but the shape is the same
+inline void hsv2rgb_rainbow(const CHSV &hsv, CRGB &rgb)
+{
+  uint8_t region = hsv.h / 43;
+  uint8_t remainder = (hsv.h - region * 43) * 6;
+  uint8_t p = (hsv.v * (255 - hsv.s)) >> 8;
+  uint8_t q = (hsv.v * (255 - ((hsv.s * remainder) >> 8))) >> 8;
+  uint8_t t = (hsv.v * (255 - ((hsv.s * (255 - remainder)) >> 8))) >> 8;
+  switch (region)
+  {
+  case 0:
+    rgb = CRGB(hsv.v, t, p);
+    break;
+  case 1:
+    rgb = CRGB(q, hsv.v, p);
+    break;
+  case 2:
+    rgb = CRGB(p, hsv.v, t);
+    break;
+  case 3:
+    rgb = CRGB(p, q, hsv.v);
+    break;
+  case 4:
+    rgb = CRGB(t, p, hsv.v);
+    break;
+  default:
+    rgb = CRGB(hsv.v, p, q);
+    break;
+  }
+}
+
+/**
+ * mock controller recording every frame sent to the strip
+ * showing a frame advances the host clock by the modeled wire time of a clockless 800 kHz chipset
+*/
+class CLEDController
+{
+protected:
+  CRGB *m_data;
+  int m_num_leds;
+  uint8_t m_pin;
+
+public:
+  uint32_t shows = 0;        // frames sent
+  uint32_t bytes_sent = 0;   // bytes sent over all frames
+  uint32_t wire_time = 0;    // modeled time on the wire over all frames in us
+  std::vector<CRGB> frame;   // copy of the last frame sent
+
+  CLEDController(CRGB *data, const int num_leds, const uint8_t pin) : m_data(data), m_num_leds(num_leds), m_pin(pin) {}
+  virtual ~CLEDController() {}
+
+  // 24 bit per led at 800 kHz plus 50 us reset
+  static uint32_t modeledTime(const int num_leds)
+  {
+    return num_leds * 30UL + 50;
+  }
+
+  void showLeds(const uint8_t brightness = 255)
+  {
+    frame.resize(m_num_leds);
+    for (int i = 0; i < m_num_leds; i++)
+    {
+      frame[i] = m_data[i];
+      if (brightness != 255)
+        frame[i].nscale8(brightness);
+    }
+
+    uint32_t t = modeledTime(m_num_leds);
+    shows++;
+    bytes_sent += m_num_leds * 3;
+    wire_time += t;
+    hostAdvanceMicros(t);
+  }
+
+  inline int size()
+  {
+    return m_num_leds;
+  }
+
+  inline CRGB *leds()
+  {
+    return m_data;
+  }
+
+  inline uint8_t getPin()
+  {
+    return m_pin;
+  }
+};
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER = GRB>
+class WS2812B
+{
+};
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER = RGB>
+class WS2811
+{
+};
+
+template <uint8_t DATA_PIN, EOrder RGB_ORDER = RGB>
+class SK6812
+{
+};
+
+class CFastLED
+{
+protected:
+  std::vector<CLEDController *> m_controllers;
+  uint8_t m_dither = 1;
+
+public:
+  template <template <uint8_t DATA_PIN, EOrder RGB_ORDER> class CHIPSET, uint8_t DATA_PIN, EOrder RGB_ORDER>
+  CLEDController &addLeds(CRGB *data, const int num_leds)
+  {
+    CLEDController *c = new CLEDController(data, num_leds, DATA_PIN);
+    m_controllers.push_back(c);
+    return *c;
+  }
+
+  inline void setDither(const uint8_t dither)
+  {
+    m_dither = dither;
+  }
+
+  inline uint8_t getDither()
+  {
+    return m_dither;
+  }
+
+  inline int count()
+  {
+    return m_controllers.size();
+  }
+
+  inline CLEDController &operator[](const int x)
+  {
+    return *m_controllers[x];
+  }
+};
+
+inline CFastLED &hostFastLED()
+{
+  static CFastLED fastled;
+  return fastled;
+}
+
+#define FastLED hostFastLED()
+
+#endif //FASTLED_H
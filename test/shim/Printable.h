@@ -0,0 +1,7 @@
+#ifndef PRINTABLE_H
+#define PRINTABLE_H
+
+// Printable is declared by the Arduino.h shim, like in the esp8266 core
+#include <Arduino.h>
+
+#endif //PRINTABLE_H
@@ -0,0 +1,91 @@
+#ifndef STREAM_PACKETS_H
+#define STREAM_PACKETS_H
+
+/**
+ * builds DDP and E1.31 packets as sent by show controllers, used by the receiver tests and the replay tool
+*/
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+typedef std::vector<uint8_t> Packet;
+
+static const uint16_t DDP_MAX_DATA = 1440; // 480 leds, fits into one ethernet frame
+static const uint16_t E131_LEDS_PER_UNIVERSE = 170;
+
+inline Packet ddpPacket(const uint8_t flags, const uint8_t seq, const uint32_t offset, const uint8_t *data, const uint16_t len)
+{
+  Packet p = {(uint8_t)(0x40 | flags), seq, 1, 1,
+              (uint8_t)(offset >> 24), (uint8_t)(offset >> 16), (uint8_t)(offset >> 8), (uint8_t)offset,
+              (uint8_t)(len >> 8), (uint8_t)len};
+  p.insert(p.end(), data, data + len);
+  return p;
+}
+
+inline void e131Root(Packet &p, const uint8_t root_vector)
+{
+  p[1] = 0x10; // preamble size
+  memcpy(&p[4], "ASC-E1.17", 9);
+  p[21] = root_vector;
+}
+
+inline Packet e131Packet(const uint16_t universe, const uint8_t seq, const uint16_t sync, const uint8_t *data, const uint16_t len)
+{
+  Packet p(126, 0);
+  e131Root(p, 0x04);
+  p[43] = 0x02; // framing vector data
+  p[109] = sync >> 8;
+  p[110] = sync;
+  p[111] = seq;
+  p[113] = universe >> 8;
+  p[114] = universe;
+  p[117] = 0x02; // dmp set property
+  p[123] = (len + 1) >> 8; // property count including start code
+  p[124] = len + 1;
+  p.insert(p.end(), data, data + len);
+  return p;
+}
+
+inline Packet e131Sync(const uint16_t address, const uint8_t seq = 0)
+{
+  Packet p(49, 0);
+  e131Root(p, 0x08);
+  p[43] = 0x01; // framing vector sync
+  p[44] = seq;
+  p[45] = address >> 8;
+  p[46] = address;
+  return p;
+}
+
+/**
+ * split one frame of rgb data into packets
+ * DDP sets the push flag on the last packet, E1.31 uses one universe per 170 leds starting at universe 1
+ * @param seq last sequence number, DDP numbers every packet 1..15, E1.31 every frame of a universe 0..255
+*/
+inline std::vector<Packet> framePackets(const bool e131, const uint8_t *rgb, const uint16_t num_leds, uint8_t &seq)
+{
+  std::vector<Packet> packets;
+  const uint32_t bytes = num_leds * 3;
+  if (e131)
+  {
+    for (uint32_t offset = 0, universe = 1; offset < bytes; offset += E131_LEDS_PER_UNIVERSE * 3, universe++)
+    {
+      uint16_t len = bytes - offset < E131_LEDS_PER_UNIVERSE * 3u ? bytes - offset : E131_LEDS_PER_UNIVERSE * 3;
+      packets.push_back(e131Packet(universe, seq, 0, rgb + offset, len));
+    }
+    seq++;
+  }
+  else
+  {
+    for (uint32_t offset = 0; offset < bytes; offset += DDP_MAX_DATA)
+    {
+      uint16_t len = bytes - offset < DDP_MAX_DATA ? bytes - offset : DDP_MAX_DATA;
+      seq = seq % 15 + 1;
+      packets.push_back(ddpPacket(offset + len >= bytes ? 0x01 : 0x00, seq, offset, rgb + offset, len));
+    }
+  }
+  return packets;
+}
+
+#endif //STREAM_PACKETS_H
@@ -0,0 +1,84 @@
+#ifndef LED_TEST_H
+#define LED_TEST_H
+
+/**
+ * minimal test framework for the host build
+ * every TEST() registers itself, test_main.cpp runs all of them and fails if any CHECK failed
+*/
+
+#include <Arduino.h>
+#include <FastLED.h>
+#include <stdio.h>
+
+struct TestCase
+{
+  const char *name;
+  void (*run)();
+  TestCase *next;
+};
+
+inline TestCase *&testCases()
+{
+  static TestCase *first = nullptr;
+  return first;
+}
+
+inline int &testFailures()
+{
+  static int failures = 0;
+  return failures;
+}
+
+struct TestRegistrar
+{
+  TestRegistrar(TestCase &test)
+  {
+    // keep the order of definition
+    TestCase **last = &testCases();
+    while (*last)
+      last = &(*last)->next;
+    *last = &test;
+  }
+};
+
+#define TEST(name)                                              \
+  static void test_##name();                                    \
+  static TestCase test_case_##name = {#name, test_##name, nullptr}; \
+  static TestRegistrar test_registrar_##name(test_case_##name); \
+  static void test_##name()
+
+inline bool testCheck(const bool ok, const char *expr, const char *file, const int line)
+{
+  if (!ok)
+  {
+    printf("%s:%d: CHECK(%s) failed\n", file, line, expr);
+    testFailures()++;
+  }
+  return ok;
+}
+
+inline bool testCheckEq(const long long a, const long long b, const char *expr_a, const char *expr_b, const char *file, const int line)
+{
+  if (a != b)
+  {
+    printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", file, line, expr_a, expr_b, a, b);
+    testFailures()++;
+  }
+  return a == b;
+}
+
+inline bool testCheckColor(const CRGB &a, const CRGB &b, const char *expr_a, const char *expr_b, const char *file, const int line)
+{
+  if (a != b)
+  {
+    printf("%s:%d: CHECK_COLOR(%s, %s) failed: (%d, %d, %d) != (%d, %d, %d)\n", file, line, expr_a, expr_b, a.r, a.g, a.b, b.r, b.g, b.b);
+    testFailures()++;
+  }
+  return a == b;
+}
+
+#define CHECK(expr) testCheck((expr), #expr, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) testCheckEq((long long)(a), (long long)(b), #a, #b, __FILE__, __LINE__)
+#define CHECK_COLOR(a, b) testCheckColor((a), (b), #a, #b, __FILE__, __LINE__)
+
+#endif //LED_TEST_H
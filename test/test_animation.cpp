@@ -0,0 +1,177 @@
+#include "test.h"
+#include "host_strip.h"
+#include "animation_clips.h"
+
+#include <LED_Animation.h>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+static void encodeClip(Buffer_Print &out, const CLIP clip, const uint16_t n, const uint32_t frames, const uint16_t keyframes = 0)
+{
+  LED_Animation_Encoder enc(out, n, 40, keyframes);
+  std::vector<CRGB> frame(n);
+  for (uint32_t f = 0; f < frames; f++)
+  {
+    clipFrame(clip, f, frame.data(), n);
+    enc.addFrame(frame.data());
+  }
+  CHECK_EQ(enc.getBytes(), out.data.size());
+}
+
+// step through all frames and compare the raw buffer with the clip
+template <class SOURCE>
+static bool playsExactly(SOURCE &source, const CLIP clip, const uint16_t n, const uint32_t frames)
+{
+  LED_Animation_Player<SOURCE> player(source);
+  player.setLoop(false);
+  if (!CHECK(player.begin()))
+    return false;
+  CHECK_EQ(player.getNumLeds(), n);
+  CHECK_EQ(player.getFps(), 40);
+
+  Host_Strip s(n);
+  s.begin();
+  std::vector<CRGB> expected(n);
+  for (uint32_t f = 0; f < frames; f++)
+  {
+    if (!CHECK(player.step(s)))
+      return false;
+    clipFrame(clip, f, expected.data(), n);
+    for (uint16_t i = 0; i < n; i++)
+      if (!CHECK_COLOR(s.getRawColor(i), expected[i]))
+      {
+        printf("frame %u led %u\n", f, i);
+        return false;
+      }
+  }
+  CHECK(!player.step(s));
+  return CHECK(player.isFinished()) && CHECK(player.isValid());
+}
+
+TEST(animation_clips_decode_exactly)
+{
+  const uint16_t n = 300;
+  for (uint8_t c = 0; c < CLIP_COUNT; c++)
+  {
+    Buffer_Print file;
+    encodeClip(file, (CLIP)c, n, 120);
+    printf("animation: %-8s %u leds x 120 frames in %zu bytes\n", CLIP_NAMES[c], n, file.data.size());
+
+    LED_Memory_Source memory(file.data.data(), file.data.size());
+    playsExactly(memory, (CLIP)c, n, 120);
+
+    Memory_File fs(file.data);
+    LED_Chunked_Source<Memory_File> chunked(fs);
+    playsExactly(chunked, (CLIP)c, n, 120);
+  }
+}
+
+TEST(animation_delta_frames_are_small)
+{
+  const uint16_t n = 1000;
+  Buffer_Print comet, twinkle, keyframes;
+  encodeClip(comet, CLIP_COMET, n, 100);
+  encodeClip(twinkle, CLIP_TWINKLE, n, 100);
+  encodeClip(keyframes, CLIP_TWINKLE, n, 100, 1);
+  printf("animation: comet %zu bytes, twinkle %zu bytes, twinkle keyframes only %zu bytes\n",
+         comet.data.size(), twinkle.data.size(), keyframes.data.size());
+  // the comet changes 17 leds per frame
+  CHECK(comet.data.size() < 100 * 80 + 1000);
+  // the gradient is coded once, sparkles change a few leds every 4 frames
+  CHECK(keyframes.data.size() > twinkle.data.size() * 10);
+}
+
+TEST(animation_loops)
+{
+  const uint16_t n = 60;
+  Buffer_Print file;
+  encodeClip(file, CLIP_TWINKLE, n, 10, 4);
+  LED_Memory_Source source(file.data.data(), file.data.size());
+  LED_Animation_Player<LED_Memory_Source> player(source);
+  CHECK(player.begin());
+
+  Host_Strip s(n);
+  s.begin();
+  std::vector<CRGB> expected(n);
+  for (uint32_t f = 0; f < 35; f++)
+    CHECK(player.step(s));
+  clipFrame(CLIP_TWINKLE, 34 % 10, expected.data(), n);
+  for (uint16_t i = 0; i < n; i++)
+    CHECK_COLOR(s.getRawColor(i), expected[i]);
+  CHECK_EQ(player.getFrame(), 35);
+}
+
+TEST(animation_plays_at_frame_rate)
+{
+  const uint16_t n = 30;
+  Buffer_Print file;
+  encodeClip(file, CLIP_COMET, n, 100); // 40 fps
+  LED_Memory_Source source(file.data.data(), file.data.size());
+  LED_Animation_Player<LED_Memory_Source> player(source);
+  player.begin();
+
+  Host_Strip s(n);
+  s.begin();
+  CHECK_EQ(player.nextUpdateDue(), 0);
+  CHECK(player.render(s)); // first frame immediately
+  CHECK_EQ(player.getFrame(), 1);
+  for (uint32_t ms = 0; ms < 1000; ms++)
+  {
+    hostAdvanceMillis(1);
+    player.render(s);
+  }
+  CHECK_EQ(player.getFrame(), 41);
+  CHECK(player.nextUpdateDue() <= 25);
+}
+
+TEST(animation_rejects_bad_files)
+{
+  const uint16_t n = 50;
+  Buffer_Print file;
+  encodeClip(file, CLIP_RAINBOW, n, 3);
+  Host_Strip s(n), small(n - 1);
+  s.begin();
+  small.begin();
+
+  LED_Memory_Source source(file.data.data(), file.data.size());
+  LED_Animation_Player<LED_Memory_Source> player(source);
+  CHECK(player.begin());
+  CHECK(!player.step(small)); // strip too short
+
+  std::vector<uint8_t> bad = file.data;
+  bad[0] = 'X';
+  LED_Memory_Source bad_header(bad.data(), bad.size());
+  LED_Animation_Player<LED_Memory_Source> p1(bad_header);
+  CHECK(!p1.begin());
+  CHECK_EQ(p1.nextUpdateDue(), LED_Strip::NEVER);
+
+  // truncated in the middle of the first frame
+  LED_Memory_Source truncated(file.data.data(), LED_ANIMATION_HEADER + 20);
+  LED_Animation_Player<LED_Memory_Source> p2(truncated);
+  CHECK(p2.begin());
+  CHECK(!p2.step(s));
+  CHECK(!p2.isValid());
+}
+
+TEST(animation_mapped_file)
+{
+  const uint16_t n = 200;
+  Buffer_Print file;
+  encodeClip(file, CLIP_COMET, n, 50);
+
+  char path[] = "/tmp/led_animation_XXXXXX";
+  int fd = mkstemp(path);
+  CHECK(fd >= 0);
+  CHECK_EQ(write(fd, file.data.data(), file.data.size()), file.data.size());
+  close(fd);
+  {
+    LED_Mapped_File mapped(path);
+    if (CHECK(mapped.isOpen()))
+      playsExactly(mapped, CLIP_COMET, n, 50);
+  }
+  unlink(path);
+
+  LED_Mapped_File missing("/nonexistent/animation");
+  CHECK(!missing.isOpen());
+}
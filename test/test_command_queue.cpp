@@ -0,0 +1,162 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <LED_Command_Queue.h>
+#include <LED_Segment.h>
+
+#include <atomic>
+#include <thread>
+
+TEST(queue_coalesces_in_order)
+{
+  const uint16_t n = 16;
+  Host_Strip s(n);
+  s.begin();
+  LED_Command_Queue<256> q(s);
+  q.setBrightness(10).setBrightness(20).setColor(CRGB::Red).setSingleColor(CRGB::Blue, 2);
+  q.setColor(CRGB::Green).setSingleColor(CRGB::White, 3).setPower(0).setPower(1);
+  CHECK(!q.pending()); // nothing before commit
+  CHECK(q.commit());
+  CHECK(q.pending());
+  CHECK_EQ(s.nextUpdateDue(), 0);
+
+  s.update();
+  CHECK(!q.pending());
+  CHECK_EQ(s.getMode(), LED_Strip::MODE::MANY);
+  CHECK_EQ(s.getBrightness(), 20);
+  CHECK_COLOR(s.getRawColor(3), CRGB::White);
+  CHECK(s.getRawColor(2) != CRGB(CRGB::Blue)); // the last color replaced the blue pixel
+  CHECK_EQ(q.getApplied(), 4);
+  CHECK_EQ(q.getCoalesced(), 4);
+}
+
+TEST(queue_coalesces_repeated_pixels)
+{
+  Host_Strip s(8);
+  s.begin();
+  LED_Command_Queue<16> q(s);
+  q.setSingleColor(CRGB::Red, 1).setSingleColor(CRGB::Blue, 2).setSingleColor(CRGB::Green, 1);
+  CHECK(q.setSingleColor(CRGB::White, 1).commit());
+  CHECK(q.setSingleColor(CRGB::Red, 2).setSingleColor(CRGB::Blue, 9).commit()); // both groups drain in one frame
+  s.update();
+  CHECK_COLOR(s.getRawColor(1), CRGB::White);
+  CHECK_COLOR(s.getRawColor(2), CRGB::Red);
+  CHECK_COLOR(s.getRawColor(3), CRGB(0));
+  CHECK_EQ(q.getApplied(), 3);
+  CHECK_EQ(q.getCoalesced(), 3);
+
+  // every pixel of a full queue is distinct, colliding slots included
+  for (uint16_t i = 0; i < 16; i++)
+    q.setSingleColor(CRGB(i + 1, 0, 0), (i & 1) * 16 + i / 2);
+  CHECK(q.commit());
+  s.update();
+  CHECK_EQ(q.getApplied(), 3 + 16);
+  CHECK_EQ(q.getCoalesced(), 3);
+  for (uint16_t i = 0; i < 8; i++)
+    CHECK_COLOR(s.getRawColor(i), CRGB(2 * i + 1, 0, 0));
+}
+
+TEST(queue_overflow_drops_whole_group)
+{
+  Host_Strip s(4);
+  s.begin();
+  LED_Command_Queue<256> q(s);
+  for (uint16_t i = 0; i < 300; i++)
+    q.setSingleColor(CRGB(1, 1, 1), 0);
+  CHECK(!q.commit());
+  CHECK_EQ(q.getDropped(), 1);
+  CHECK(!q.pending());
+
+  // the queue is usable again
+  CHECK(q.setSingleColor(CRGB(5, 5, 5), 1).commit());
+  s.update();
+  CHECK_COLOR(s.getRawColor(1), CRGB(5, 5, 5));
+  CHECK_COLOR(s.getRawColor(0), CRGB(0));
+}
+
+TEST(queue_drained_by_parent_with_segments)
+{
+  Host_Strip parent(20);
+  parent.begin();
+  LED_Segment a(parent, 0, 10), b(parent, 10, 10);
+  for (LED_Segment *seg : {&a, &b})
+  {
+    seg->init(CRGB::Black, 255, 0);
+    seg->setBrightness(255);
+    seg->setPower(true);
+  }
+  LED_Command_Queue<> q(parent), qa(a);
+  parent.update();
+  CHECK_EQ(parent.nextUpdateDue(), LED_Strip::NEVER);
+
+  q.setBrightness(50).commit();
+  CHECK_EQ(parent.nextUpdateDue(), 0);
+  parent.update();
+  CHECK(!q.pending());
+  CHECK_EQ(parent.nextUpdateDue(), LED_Strip::NEVER); // the applied queue is not due forever
+
+  // queues of segments are applied when the parent renders them
+  qa.setSingleColor(CRGB::Red, 4).commit();
+  CHECK_EQ(parent.nextUpdateDue(), 0);
+  uint32_t shows = parent.shows;
+  parent.update();
+  CHECK(!qa.pending());
+  CHECK_EQ(parent.shows, shows + 1);
+  CHECK(parent.out(4) != CRGB(0));
+  CHECK_COLOR(parent.out(5), CRGB(0));
+  CHECK_EQ(parent.nextUpdateDue(), LED_Strip::NEVER);
+}
+
+/**
+ * producer thread commits whole frames while the main thread renders, no frame may show a partly applied group
+*/
+TEST(queue_stress_no_torn_frames)
+{
+  const uint16_t n = 16;
+  Host_Strip s(n);
+  s.begin();
+  LED_Command_Queue<256> q(s);
+  std::atomic<bool> done(false);
+  uint64_t groups = 0;
+
+  std::thread producer([&]() {
+    uint8_t k = 1;
+    for (uint32_t attempt = 0; attempt < 20000; attempt++)
+    {
+      for (uint16_t i = 0; i < n; i++)
+        q.setSingleColor(CRGB(k, k, k), i);
+      if (q.commit())
+      {
+        groups++;
+        k = k % 250 + 1;
+      }
+      else
+        std::this_thread::yield(); // queue full, let the consumer run on a single core host
+    }
+    done = true;
+  });
+
+  uint64_t frames = 0, torn = 0;
+  while (!done)
+  {
+    s.update();
+    frames++;
+    CRGB c = s.getRawColor(0);
+    for (uint16_t i = 1; i < n; i++)
+      if (s.getRawColor(i) != c)
+      {
+        torn++;
+        break;
+      }
+    std::this_thread::yield();
+  }
+  producer.join();
+  s.update();
+
+  printf("queue: %llu frames, %llu groups committed, applied %u coalesced %u dropped %u\n",
+         (unsigned long long)frames, (unsigned long long)groups, q.getApplied(), q.getCoalesced(), q.getDropped());
+  CHECK_EQ(torn, 0);
+  CHECK(groups > 0);
+  CHECK(!q.pending());
+  CHECK_EQ(q.getApplied() + q.getCoalesced(), groups * n);
+}
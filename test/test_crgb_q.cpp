@@ -0,0 +1,106 @@
+#include "test.h"
+
+#include <CRGB_d.h>
+#include <CRGB_q.h>
+
+#include <math.h>
+
+// largest channel difference in units of 0 - 255
+static double maxError(const CRGB_d &a, const CRGB_q &b)
+{
+  double e = 0;
+  for (uint8_t i = 0; i < 3; i++)
+    e = fmax(e, fabs(a[i] - b[i].toDouble()));
+  return e;
+}
+
+TEST(channels_read_and_write_q8_8)
+{
+  CRGB_q c(CRGB(200, 100, 50));
+  CHECK_EQ(c.r, 200 << 8);
+  CHECK_EQ(c.g, 100 << 8);
+  CHECK_EQ(c[2], 50 << 8);
+  CHECK_EQ(c.r.q, 200 << 8);
+  CHECK(c.r.toDouble() == 200);
+  CHECK_COLOR(c.toCRGB(), CRGB(200, 100, 50));
+
+  c.r = 10 << 8 | 0x80;
+  c[1] = 300 << 8; // saturates like every other operation
+  c.blue -= 60 << 8;
+  CHECK(c.red.toDouble() == 10.5);
+  CHECK_EQ(c.g, CRGB_q::MAX_Q);
+  CHECK_EQ(c.b, 0);
+
+  c.g.setDouble(127.5);
+  CHECK_EQ(c.g, 127 << 8 | 0x80);
+  c.g += 200 << 8;
+  CHECK_EQ(c.g, CRGB_q::MAX_Q);
+  c.g.setDouble(-1);
+  CHECK_EQ(c.g, 0);
+}
+
+TEST(setHSB_matches_CRGB_d)
+{
+  double worst = 0;
+  for (int32_t hue = 0; hue < 65535; hue += 97)
+  {
+    for (uint16_t sat = 1; sat < 256; sat += 13)
+    {
+      for (uint16_t bri = 0; bri < 256; bri += 17)
+      {
+        CRGB_d d;
+        CRGB_q q;
+        d.setHSB(hue, sat, bri);
+        q.setHSB(hue, sat, bri);
+        worst = fmax(worst, maxError(d, q));
+      }
+    }
+  }
+  CHECK(worst <= 0.02);
+}
+
+TEST(setXY_matches_CRGB_d)
+{
+  // gamut of the hue bridges on a 0.01 grid
+  double worst = 0;
+  for (uint8_t ix = 0; ix <= 80; ix++)
+  {
+    for (uint8_t iy = 1; ix + iy <= 90; iy++)
+    {
+      CRGB_d d;
+      CRGB_q q;
+      d.setXY(ix / 100.0f, iy / 100.0f, 200);
+      q.setXY(ix / 100.0f, iy / 100.0f, 200);
+      worst = fmax(worst, maxError(d, q));
+    }
+  }
+  CHECK(worst <= 0.42);
+}
+
+TEST(operators_match_CRGB_d)
+{
+  CRGB_d d(100.5, 20, 3);
+  CRGB_q q(100.5, 20, 3);
+  d *= 1.7;
+  q *= 1.7;
+  CHECK(maxError(d, q) < 0.01);
+  d /= 3.3;
+  q /= 3.3;
+  CHECK(maxError(d, q) < 0.01);
+  d += CRGB_d(200, 1, 1);
+  q += CRGB_q(200, 1, 1);
+  d.fixOverflow8();
+  CHECK(maxError(d, q) < 0.01);
+  d = -d;
+  q = -q;
+  CHECK(maxError(d, q) < 0.01);
+  d.subtractFromRGB(10.25);
+  q.subtractFromRGB(10.25);
+  d.fixOverflow8();
+  CHECK(maxError(d, q) < 0.01);
+}
+
+TEST(is_smaller_than_CRGB_d)
+{
+  CHECK(sizeof(CRGB_q) < sizeof(CRGB_d));
+}
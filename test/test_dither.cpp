@@ -0,0 +1,52 @@
+#include "test.h"
+#include "host_strip.h"
+
+TEST(curve_16bit_matches_8bit)
+{
+  for (uint16_t x = 0; x < 256; x++)
+    CHECK_EQ(ledLinBrightness_16bit(x << 8) >> 8, ledLinBrightness(x));
+}
+
+TEST(dither_averages_to_16bit_value)
+{
+  DitheredColorTable table;
+  table.update(40, CRGB(255, 176, 240));
+  for (uint16_t x = 0; x < 256; x++)
+  {
+    uint8_t err[3] = {0, 85, 170};
+    uint32_t sum[3] = {0, 0, 0};
+    for (uint16_t frame = 0; frame < 256; frame++)
+    {
+      CRGB c = table.dither(CRGB(x, x, x), err);
+      sum[0] += c.r;
+      sum[1] += c.g;
+      sum[2] += c.b;
+    }
+    // 256 frames of 8 bit output carry the whole 16 bit value, up to one step of remaining error
+    CHECK(abs((int32_t)sum[0] - scaledChannel16(x, 40, 255)) <= 1);
+    CHECK(abs((int32_t)sum[1] - scaledChannel16(x, 40, 176)) <= 1);
+    CHECK(abs((int32_t)sum[2] - scaledChannel16(x, 40, 240)) <= 1);
+  }
+}
+
+TEST(dim_color_is_not_lost)
+{
+  Host_Strip plain(8), dithered(8);
+  plain.begin(CRGB(40, 40, 40), 20);
+  dithered.begin(CRGB(40, 40, 40), 20);
+  dithered.setDither(true);
+
+  uint32_t lit = 0;
+  for (uint16_t frame = 0; frame < 256; frame++)
+  {
+    hostAdvanceMillis(20);
+    plain.update();
+    dithered.update();
+    for (uint16_t i = 0; i < 8; i++)
+      lit += dithered.out(i).r;
+  }
+  // 8 bit scaling rounds this color to black, dithering shows it on average
+  CHECK_COLOR(plain.out(0), CRGB::Black);
+  CHECK(abs((int32_t)(lit / 8) - scaledChannel16(40, 20, 255)) <= 1);
+  CHECK_EQ(dithered.shows, 256);
+}
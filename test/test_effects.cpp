@@ -0,0 +1,85 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <LED_Effects.h>
+
+// effect counting its steps
+class Count_Effect : public LED_Effect<Count_Effect>
+{
+public:
+  uint32_t steps = 0;
+
+  Count_Effect() : LED_Effect(20) {}
+
+  template <class STRIP>
+  void step(STRIP &)
+  {
+    steps++;
+  }
+};
+
+TEST(effect_speed_does_not_depend_on_call_rate)
+{
+  Host_Strip s(10);
+  Count_Effect fast, slow;
+  for (uint32_t t = 0; t < 1000; t += 5)
+    fast.render(s, 5);
+  for (uint32_t t = 0; t < 1000; t += 40)
+    slow.render(s, 40);
+  CHECK_EQ(fast.steps, 50);
+  CHECK_EQ(slow.steps, 50);
+}
+
+TEST(effect_catch_up_is_limited)
+{
+  Host_Strip s(10);
+  Count_Effect e;
+  e.render(s, 1000);
+  CHECK_EQ(e.steps, Count_Effect::MAX_CATCH_UP);
+  CHECK_EQ(e.nextStepDue(0), 20);
+  CHECK_EQ(e.nextStepDue(15), 5);
+  CHECK_EQ(e.nextStepDue(20), 0);
+}
+
+TEST(engine_dispatches_selected_effect)
+{
+  Host_Strip s(10);
+  s.begin();
+  LED_Effect_Engine<Count_Effect, SectionColor_Effect> engine;
+  CHECK(!engine.select(2));
+  CHECK(engine.select(1));
+  engine.get<SectionColor_Effect>().setSectionSize(2);
+
+  engine.render(s); // first call only starts the clock
+  hostAdvanceMillis(20);
+  engine.render(s);
+  s.update();
+  CHECK_EQ(engine.get<Count_Effect>().steps, 0);
+  CHECK_COLOR(s.out(0), scaledColor(CRGB::Red, 255, CRGB(0xFFFFFF)));
+  CHECK_COLOR(s.out(2), scaledColor(CRGB::Green, 255, CRGB(0xFFFFFF)));
+  CHECK_COLOR(s.out(4), scaledColor(CRGB::Blue, 255, CRGB(0xFFFFFF)));
+
+  engine.select(0);
+  hostAdvanceMillis(45);
+  engine.render(s);
+  CHECK_EQ(engine.get<Count_Effect>().steps, 2);
+  CHECK_EQ(engine.nextUpdateDue(), 15);
+}
+
+TEST(strip_methods_match_effect_classes)
+{
+  Host_Strip a(30), b(30);
+  a.begin();
+  b.begin();
+  MovingPoint_Effect point;
+  point.setColor(CRGB::Red);
+  for (uint8_t i = 0; i < 70; i++)
+  {
+    a.movingPoint(CRGB::Red);
+    point.step(b);
+  }
+  a.update();
+  b.update();
+  for (uint16_t i = 0; i < 30; i++)
+    CHECK_COLOR(a.out(i), b.out(i));
+}
@@ -0,0 +1,169 @@
+#include "test.h"
+
+#include <led_kernels.h>
+
+/**
+ * every kernel is compared to the scalar FastLED function for all lengths up to MAX_LEN
+ * and all start offsets within a word, so vector, word and tail loops are all covered
+*/
+static const size_t MAX_LEN = 70;
+static const size_t MAX_OFFSET = sizeof(led_word_t);
+
+static void fillRandom(uint8_t *p, const size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    p[i] = random8();
+}
+
+// bytes around the processed range must not be touched
+static bool checkGuard(const uint8_t *buf, const uint8_t *ref, const size_t offset, const size_t n)
+{
+  for (size_t i = 0; i < offset; i++)
+    if (buf[i] != ref[i])
+      return false;
+  for (size_t i = offset + n; i < MAX_LEN + 2 * MAX_OFFSET; i++)
+    if (buf[i] != ref[i])
+      return false;
+  return true;
+}
+
+TEST(kernel_path)
+{
+#if defined(LED_KERNELS_AVX2)
+  printf("kernels: AVX2 + %zu byte words\n", sizeof(led_word_t));
+#elif defined(LED_KERNELS_SSE2)
+  printf("kernels: SSE2 + %zu byte words\n", sizeof(led_word_t));
+#elif defined(LED_KERNELS_NEON)
+  printf("kernels: NEON + %zu byte words\n", sizeof(led_word_t));
+#else
+  printf("kernels: %zu byte words\n", sizeof(led_word_t));
+#endif
+}
+
+TEST(bulkScale8_matches_scale8)
+{
+  uint8_t buf[MAX_LEN + 2 * MAX_OFFSET], ref[sizeof(buf)];
+  for (uint16_t scale = 0; scale < 256; scale++)
+  {
+    for (size_t offset = 0; offset < MAX_OFFSET; offset++)
+    {
+      for (size_t n = 0; n <= MAX_LEN; n++)
+      {
+        fillRandom(ref, sizeof(ref));
+        memcpy(buf, ref, sizeof(buf));
+        bulkScale8(buf + offset, n, scale);
+        for (size_t i = 0; i < n; i++)
+          ref[offset + i] = scale8(ref[offset + i], scale);
+        if (!CHECK(memcmp(buf, ref, sizeof(buf)) == 0))
+        {
+          printf("scale %u offset %zu length %zu\n", scale, offset, n);
+          return;
+        }
+      }
+    }
+  }
+}
+
+TEST(bulkScale8_matches_nscale8)
+{
+  CRGB leds[MAX_LEN], ref[MAX_LEN];
+  fillRandom((uint8_t *)ref, sizeof(ref));
+  memcpy(leds, ref, sizeof(leds));
+  bulkScale8((uint8_t *)leds, MAX_LEN * 3, 100);
+  for (size_t i = 0; i < MAX_LEN; i++)
+  {
+    ref[i].nscale8(100);
+    CHECK_COLOR(leds[i], ref[i]);
+  }
+}
+
+/**
+ * compare a two operand kernel against its scalar version
+ * dst and src are shifted against each other so their alignment differs
+*/
+template <class KERNEL, class SCALAR>
+static void checkBinary(const char *name, KERNEL kernel, SCALAR scalar)
+{
+  uint8_t dst[MAX_LEN + 2 * MAX_OFFSET], src[sizeof(dst)], ref[sizeof(dst)];
+  for (uint8_t pattern = 0; pattern < 4; pattern++)
+  {
+    for (size_t offset = 0; offset < MAX_OFFSET; offset++)
+    {
+      for (size_t n = 0; n <= MAX_LEN; n++)
+      {
+        fillRandom(ref, sizeof(ref));
+        fillRandom(src, sizeof(src));
+        if (pattern == 1) // equal values
+          memcpy(src, ref, sizeof(src));
+        else if (pattern == 2) // values around the top bit
+          for (size_t i = 0; i < sizeof(src); i++)
+            src[i] = ref[i] ^ 0x80;
+        else if (pattern == 3) // extremes
+          for (size_t i = 0; i < sizeof(src); i++)
+            src[i] = (i & 1) ? 0xFF : 0x00;
+        memcpy(dst, ref, sizeof(dst));
+
+        const uint8_t *s = src + MAX_OFFSET - offset;
+        kernel(dst + offset, s, n);
+        for (size_t i = 0; i < n; i++)
+          ref[offset + i] = scalar(ref[offset + i], s[i]);
+        if (!CHECK(memcmp(dst, ref, sizeof(dst)) == 0 && checkGuard(dst, ref, offset, n)))
+        {
+          printf("%s pattern %u offset %zu length %zu\n", name, pattern, offset, n);
+          return;
+        }
+      }
+    }
+  }
+}
+
+TEST(bulkAdd8_matches_qadd8)
+{
+  checkBinary("bulkAdd8", bulkAdd8, [](uint8_t a, uint8_t b) { return qadd8(a, b); });
+}
+
+TEST(bulkMax8_matches_max)
+{
+  checkBinary("bulkMax8", bulkMax8, [](uint8_t a, uint8_t b) { return a > b ? a : b; });
+}
+
+TEST(bulkMin8_matches_min)
+{
+  checkBinary("bulkMin8", bulkMin8, [](uint8_t a, uint8_t b) { return a < b ? a : b; });
+}
+
+TEST(word_compare_is_exhaustive)
+{
+  // every pair of byte values in every byte position of a word
+  for (uint16_t a = 0; a < 256; a++)
+  {
+    for (uint16_t b = 0; b < 256; b++)
+    {
+      led_word_t wa = (led_word_t)a * (LED_WORD_H >> 7);
+      led_word_t wb = 0;
+      for (uint8_t k = 0; k < sizeof(led_word_t); k++)
+        wb |= (led_word_t)(uint8_t)(b + k) << (8 * k);
+      led_word_t m = ledMaskGreaterEqual(wa, wb);
+      for (uint8_t k = 0; k < sizeof(led_word_t); k++)
+      {
+        uint8_t expected = a >= (uint8_t)(b + k) ? 0xFF : 0x00;
+        if (!CHECK_EQ((m >> (8 * k)) & 0xFF, expected))
+          return;
+      }
+    }
+  }
+}
+
+TEST(bulkFill_writes_every_length)
+{
+  CRGB leds[MAX_LEN + 1];
+  for (size_t n = 0; n <= MAX_LEN; n++)
+  {
+    for (CRGB &led : leds)
+      led = CRGB(0, 0, 0);
+    bulkFill(leds, n, CRGB(1, 2, 3));
+    for (size_t i = 0; i < n; i++)
+      CHECK_COLOR(leds[i], CRGB(1, 2, 3));
+    CHECK_COLOR(leds[n], CRGB(0, 0, 0));
+  }
+}
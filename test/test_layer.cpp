@@ -0,0 +1,208 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <LED_Layer.h>
+
+// one channel of LED_Layer::blend() written out per mode
+static uint8_t referenceBlend(const uint8_t d, const uint8_t s, const LED_Layer::BLEND mode, const uint8_t opacity)
+{
+  const uint16_t a = opacity + (opacity >> 7);
+  switch (mode)
+  {
+  case LED_Layer::ALPHA:
+    return (d * (256 - a) + s * a) >> 8;
+  case LED_Layer::ADD:
+    return min(255, d + scale8(s, opacity));
+  case LED_Layer::MAX:
+    return max(d, scale8(s, opacity));
+  case LED_Layer::MULTIPLY:
+    return scale8(d, 255 - scale8(255 - s, opacity));
+  }
+  return d;
+}
+
+static const LED_Layer::BLEND MODES[] = {LED_Layer::ALPHA, LED_Layer::ADD, LED_Layer::MAX, LED_Layer::MULTIPLY};
+
+TEST(blend_modes_match_reference)
+{
+  const uint8_t opacities[] = {0, 1, 64, 127, 128, 200, 254, 255};
+  random16_set_seed(23);
+  for (const LED_Layer::BLEND mode : MODES)
+    for (const uint8_t opacity : opacities)
+      for (uint16_t n = 1; n < 40; n += 3) // bulk kernels process blocks, check the tails too
+      {
+        CRGB d[40], s[40], expected[40];
+        for (uint16_t i = 0; i < n; i++)
+        {
+          d[i] = CRGB(random8(), random8(), random8());
+          s[i] = CRGB(random8(), random8(), random8());
+          for (uint8_t c = 0; c < 3; c++)
+            expected[i].raw[c] = referenceBlend(d[i].raw[c], s[i].raw[c], mode, opacity);
+        }
+        LED_Layer::blend(d, s, n, mode, opacity);
+        for (uint16_t i = 0; i < n; i++)
+          if (!CHECK_COLOR(d[i], expected[i]))
+          {
+            printf("mode %d opacity %u led %u of %u\n", mode, opacity, i, n);
+            return;
+          }
+      }
+}
+
+TEST(blend_transparent_colors)
+{
+  CRGB d(100, 150, 200);
+  CRGB black(0), white(255, 255, 255);
+  CRGB x = d;
+  LED_Layer::blend(&x, &black, 1, LED_Layer::ADD, 255);
+  CHECK_COLOR(x, d);
+  LED_Layer::blend(&x, &black, 1, LED_Layer::MAX, 255);
+  CHECK_COLOR(x, d);
+  LED_Layer::blend(&x, &white, 1, LED_Layer::MULTIPLY, 255);
+  CHECK_COLOR(x, d);
+  LED_Layer::blend(&x, &white, 1, LED_Layer::ALPHA, 0);
+  CHECK_COLOR(x, d);
+  LED_Layer::blend(&x, &white, 1, LED_Layer::ALPHA, 255);
+  CHECK_COLOR(x, white);
+}
+
+/**
+ * background hue, additive sparkles, a multiply filter and a notification flash on 1000 leds
+*/
+struct Scene
+{
+  static const uint16_t N = 1000;
+  Host_Strip strip;
+  LED_Layer bg, sparkle, filter, flash;
+  LED_Compositor<> compositor;
+  SpectrumHue_Effect hue_effect;
+  Sparkle_Effect sparkle_effect;
+
+  Scene() : strip(N), bg(N), sparkle(N), filter(N), flash(N), compositor(strip)
+  {
+    strip.begin();
+    compositor.add(bg);
+    compositor.add(sparkle);
+    compositor.add(filter);
+    compositor.add(flash);
+    sparkle.setBlend(LED_Layer::ADD);
+    filter.setBlend(LED_Layer::MULTIPLY);
+    flash.setOpacity(128);
+    for (uint16_t i = 0; i < N; i++)
+      hue_effect.step(bg);
+    filter.setRangeColor(CRGB(255, 128, 255), 0, N);
+    flash.setRangeColor(CRGB::White, 100, 50);
+  }
+
+  // led i blended from the bottom layer up, leds a layer never wrote are transparent
+  CRGB reference(const uint16_t i, const bool flash_active = true)
+  {
+    CRGB out(0);
+    LED_Layer *layers[4] = {&bg, &sparkle, &filter, &flash};
+    for (LED_Layer *l : layers)
+    {
+      if (!l->getVisible() || (l == &flash && (!flash_active || i < 100 || i >= 150)))
+        continue;
+      CRGB c = l->getSingleColor(i);
+      for (uint8_t k = 0; k < 3; k++)
+        out.raw[k] = referenceBlend(out.raw[k], c.raw[k], l->getBlend(), l->getOpacity());
+    }
+    return out;
+  }
+
+  bool matches(const bool flash_active = true)
+  {
+    for (uint16_t i = 0; i < N; i++)
+      if (!CHECK_COLOR(strip.getRawColor(i), reference(i, flash_active)))
+      {
+        printf("led %u\n", i);
+        return false;
+      }
+    return true;
+  }
+};
+
+TEST(compose_matches_reference)
+{
+  random16_set_seed(5);
+  Scene scene;
+  CHECK(scene.compositor.compose());
+  scene.matches();
+  CHECK(!scene.compositor.compose()); // static layers are skipped
+
+  for (uint16_t f = 0; f < 50; f++)
+  {
+    scene.hue_effect.step(scene.bg);
+    scene.sparkle_effect.step(scene.sparkle);
+    scene.flash.setOpacity(f * 5);
+    scene.compositor.compose();
+  }
+  scene.matches();
+
+  scene.bg.scroll(333);
+  scene.sparkle.setVisible(false);
+  scene.compositor.compose();
+  scene.matches();
+
+  scene.flash.clear();
+  scene.compositor.compose();
+  scene.matches(false);
+}
+
+TEST(compose_skips_unchanged_leds)
+{
+  Scene scene;
+  scene.compositor.compose();
+
+  // leds outside of the changed range are not composed again
+  scene.strip.setSingleColor(CRGB(1, 2, 3), 10);
+  scene.sparkle.setSingleColor(CRGB(0, 0, 50), 500);
+  CHECK(scene.compositor.compose());
+  CHECK_COLOR(scene.strip.getRawColor(10), CRGB(1, 2, 3));
+  CHECK_COLOR(scene.strip.getRawColor(500), scene.reference(500));
+
+  // opacity changes recompose the written range of the layer only
+  scene.flash.setOpacity(255);
+  CHECK(scene.compositor.compose());
+  CHECK_COLOR(scene.strip.getRawColor(10), CRGB(1, 2, 3));
+  for (uint16_t i = 100; i < 150; i++)
+    CHECK_COLOR(scene.strip.getRawColor(i), CRGB::White);
+}
+
+TEST(compose_layer_count_and_size)
+{
+  Host_Strip s(10);
+  s.begin();
+  LED_Layer a(10), b(10), wrong(11);
+  LED_Compositor<2> c(s);
+  CHECK(!c.add(wrong));
+  CHECK(c.add(a));
+  CHECK(c.add(b));
+  CHECK(!c.add(a));
+
+  c.setBackground(CRGB(0, 0, 40));
+  a.setRangeColor(CRGB(90, 0, 0), 2, 3);
+  c.compose();
+  CHECK_COLOR(s.getRawColor(0), CRGB(0, 0, 40));
+  CHECK_COLOR(s.getRawColor(3), CRGB(90, 0, 0));
+}
+
+/**
+ * every layer changes in every frame, the flash opacity changes so blending takes the per channel path
+ * the 5 ms frame budget of this scene is checked by the layers/budget_1000 benchmark
+*/
+TEST(compose_four_layers_every_frame)
+{
+  random16_set_seed(7);
+  Scene scene;
+  for (uint16_t f = 0; f < 100; f++)
+  {
+    scene.hue_effect.step(scene.bg);
+    scene.sparkle_effect.step(scene.sparkle);
+    scene.filter.setSingleColor(CRGB(255, f, 255), f % Scene::N);
+    scene.flash.setOpacity(f);
+    CHECK(scene.compositor.compose());
+    scene.strip.render();
+  }
+  scene.matches();
+}
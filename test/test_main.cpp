@@ -0,0 +1,21 @@
+#include "test.h"
+
+#include <string.h>
+
+// runs all tests, or only those whose name contains the first argument
+int main(int argc, char **argv)
+{
+  const char *filter = argc > 1 ? argv[1] : nullptr;
+  int run = 0;
+  for (TestCase *t = testCases(); t; t = t->next)
+  {
+    if (filter && !strstr(t->name, filter))
+      continue;
+    int failures = testFailures();
+    t->run();
+    printf("%s %s\n", testFailures() == failures ? "[ OK ]" : "[FAIL]", t->name);
+    run++;
+  }
+  printf("%d tests, %d failed checks\n", run, testFailures());
+  return testFailures() ? 1 : 0;
+}
@@ -0,0 +1,219 @@
+#include "test.h"
+#include "host_strip.h"
+#include "matrix_naive.h"
+
+#include <LED_Matrix.h>
+
+#include <vector>
+
+/**
+ * matrix on one strip compared to a second strip written through naiveMatrixIndex()
+*/
+struct Matrix_Check
+{
+  int tw, th, tiles_x, rotation;
+  bool serpentine;
+  uint8_t w, h;
+  Host_Strip strip, naive;
+  LED_Matrix matrix;
+  std::vector<CRGB> image; // expected pixels row by row
+
+  Matrix_Check(const int tw, const int th, const int tiles_x, const int tiles_y, const bool serpentine, const int rotation)
+      : tw(tw), th(th), tiles_x(tiles_x), rotation(rotation), serpentine(serpentine),
+        w(tw * tiles_x), h(th * tiles_y), strip(w * h + 3), naive(w * h + 3),
+        matrix(strip, tw, th, tiles_x, tiles_y, serpentine, (LED_Matrix::ROTATION)rotation), image(w * h)
+  {
+    strip.begin();
+    naive.begin();
+  }
+
+  inline CRGB &at(const int x, const int y)
+  {
+    return image[y * w + x];
+  }
+
+  bool check()
+  {
+    for (uint8_t y = 0; y < h; y++)
+      for (uint8_t x = 0; x < w; x++)
+        naive.setSingleColor(at(x, y), naiveMatrixIndex(x, y, tw, th, tiles_x, serpentine, rotation));
+    strip.render();
+    naive.render();
+    for (uint8_t y = 0; y < h; y++)
+      for (uint8_t x = 0; x < w; x++)
+      {
+        uint16_t o = naiveMatrixIndex(x, y, tw, th, tiles_x, serpentine, rotation);
+        if (!CHECK_COLOR(matrix.getPixel(x, y), at(x, y)) || !CHECK_COLOR(strip.out(o), naive.out(o)))
+        {
+          printf("%dx%d panels %d wide, rotation %d serpentine %d: pixel %u %u\n", tw, th, tiles_x, rotation, serpentine, x, y);
+          return false;
+        }
+      }
+    return true;
+  }
+};
+
+TEST(matrix_matches_naive_mapping)
+{
+  const int layouts[][4] = {{8, 8, 1, 1}, {16, 16, 1, 1}, {8, 4, 3, 2}, {5, 7, 2, 3}};
+  random16_set_seed(24);
+  for (const auto &l : layouts)
+    for (int rotation = 0; rotation < 4; rotation++)
+      for (int serpentine = 0; serpentine < 2; serpentine++)
+      {
+        Matrix_Check m(l[0], l[1], l[2], l[3], serpentine, rotation);
+        CHECK_EQ(m.matrix.getWidth(), m.w);
+        CHECK_EQ(m.matrix.getHeight(), m.h);
+        for (uint8_t y = 0; y < m.h; y++)
+          for (uint8_t x = 0; x < m.w; x++)
+            m.matrix.setPixel(x, y, m.at(x, y) = CRGB(random8(1, 200), random8(), random8()));
+        if (!m.check())
+          return;
+      }
+}
+
+TEST(matrix_scroll_and_bulk_operations)
+{
+  const int layouts[][4] = {{8, 8, 1, 1}, {8, 4, 3, 2}, {5, 7, 2, 3}};
+  random16_set_seed(42);
+  for (const auto &l : layouts)
+    for (int rotation = 0; rotation < 4; rotation++)
+    {
+      Matrix_Check m(l[0], l[1], l[2], l[3], true, rotation);
+      const int w = m.w, h = m.h;
+      for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+          m.matrix.setPixel(x, y, m.at(x, y) = CRGB(x * 10, y * 10, 5));
+
+      for (int k = 0; k < 6; k++)
+      {
+        int dx = random8(21) - 10, dy = random8(21) - 10;
+        m.matrix.scroll(dx, dy);
+        std::vector<CRGB> moved(m.image.size());
+        for (int y = 0; y < h; y++)
+          for (int x = 0; x < w; x++)
+            moved[y * w + x] = m.at(((x - dx) % w + w) % w, ((y - dy) % h + h) % h);
+        m.image = moved;
+        if (!m.check())
+          return;
+
+        int y = random8(h);
+        std::vector<CRGB> row(w);
+        for (int x = 0; x < w; x++)
+          m.at(x, y) = row[x] = CRGB(x, y, 7);
+        m.matrix.setRow(y, row.data());
+        int x = random8(w);
+        m.matrix.fillColumn(x, CRGB(1, 2, 3));
+        for (int r = 0; r < h; r++)
+          m.at(x, r) = CRGB(1, 2, 3);
+        y = random8(h);
+        m.matrix.fillRow(y, CRGB(9, 9, 9));
+        for (int c = 0; c < w; c++)
+          m.at(c, y) = CRGB(9, 9, 9);
+        x = random8(w);
+        std::vector<CRGB> col(h);
+        for (int r = 0; r < h; r++)
+          m.at(x, r) = col[r] = CRGB(r, 40, x);
+        m.matrix.setColumn(x, col.data());
+        if (!m.check())
+          return;
+      }
+
+      m.matrix.fill(CRGB(4, 5, 6));
+      for (CRGB &c : m.image)
+        c = CRGB(4, 5, 6);
+      m.check();
+    }
+}
+
+TEST(matrix_limits)
+{
+  // strip too short for 4 panels
+  Host_Strip s(100);
+  s.begin();
+  LED_Matrix m(s, 8, 8, 1, 4);
+  CHECK_EQ(m.getWidth(), 8);
+  CHECK_EQ(m.getHeight(), 8);
+
+  // pixels outside are ignored
+  m.setPixel(-1, 0, CRGB::Red).setPixel(8, 0, CRGB::Red).setPixel(0, 8, CRGB::Red);
+  for (uint16_t i = 0; i < 100; i++)
+    CHECK_COLOR(s.getRawColor(i), CRGB(0));
+  CHECK_COLOR(m.getPixel(8, 8), CRGB(0));
+}
+
+TEST(matrix_size_limited_to_255)
+{
+  // exactly 255 wide and high
+  Matrix_Check wide(85, 1, 3, 2, true, 1);
+  CHECK_EQ(wide.matrix.getWidth(), 255);
+  Matrix_Check high(1, 3, 1, 85, false, 0);
+  CHECK_EQ(high.matrix.getHeight(), 255);
+  for (Matrix_Check *m : {&wide, &high})
+  {
+    for (uint8_t y = 0; y < m->h; y++)
+      for (uint8_t x = 0; x < m->w; x++)
+        m->matrix.setPixel(x, y, m->at(x, y) = CRGB(x, y, 1));
+    m->matrix.scroll(-3, -1);
+    for (uint8_t y = 0; y < m->h; y++)
+      for (uint8_t x = 0; x < m->w; x++)
+        m->at(x, y) = CRGB((x + 3) % m->w, (y + 1) % m->h, 1);
+    if (!m->check())
+      return;
+  }
+
+  // panels beyond 255 are left out
+  Host_Strip s(340 * 4);
+  s.begin();
+  LED_Matrix too_wide(s, 85, 2, 4, 2);
+  CHECK_EQ(too_wide.getWidth(), 255);
+  CHECK_EQ(too_wide.getHeight(), 4);
+  too_wide.fill(CRGB::Red);
+  CHECK_COLOR(s.getRawColor(255 * 4 - 1), CRGB::Red);
+  CHECK_COLOR(s.getRawColor(255 * 4), CRGB(0));
+
+  Host_Strip t(16 * 300);
+  t.begin();
+  LED_Matrix too_high(t, 16, 20, 1, 15);
+  CHECK_EQ(too_high.getWidth(), 16);
+  CHECK_EQ(too_high.getHeight(), 240);
+  too_high.setPixel(15, 239, CRGB::Red);
+  CHECK(t.render());
+  CHECK_COLOR(too_high.getPixel(15, 239), CRGB::Red);
+}
+
+TEST(matrix_scroll_copies_no_leds)
+{
+  Host_Strip s(256);
+  s.begin();
+  LED_Matrix m(s, 16, 16);
+  m.setPixel(3, 4, CRGB::Blue);
+  s.render();
+  m.scroll(5, -2);
+  CHECK_COLOR(s.getRawColor(4 * 16 + 3), CRGB::Blue); // storage unchanged
+  CHECK_COLOR(m.getPixel(8, 2), CRGB::Blue);
+  CHECK_COLOR(m.getPixel(3, 4), CRGB(0));
+  CHECK(s.render()); // the output is remapped
+}
+
+TEST(matrix_dithered_matches_naive_mapping)
+{
+  Matrix_Check m(8, 4, 3, 2, true, 1);
+  m.strip.setBrightness(30);
+  m.naive.setBrightness(30);
+  m.strip.setDither(true);
+  m.naive.setDither(true);
+  for (uint8_t y = 0; y < m.h; y++)
+    for (uint8_t x = 0; x < m.w; x++)
+      m.matrix.setPixel(x, y, m.at(x, y) = CRGB(x * 5, y * 9, 40));
+  m.matrix.scroll(3, 1);
+  std::vector<CRGB> moved(m.image.size());
+  for (uint8_t y = 0; y < m.h; y++)
+    for (uint8_t x = 0; x < m.w; x++)
+      moved[y * m.w + x] = m.at((x + m.w - 3) % m.w, (y + m.h - 1) % m.h);
+  m.image = moved;
+  // the fraction carried between frames has to follow the output led
+  for (uint8_t frame = 0; frame < 4; frame++)
+    if (!m.check())
+      return;
+}
@@ -0,0 +1,170 @@
+#include "test.h"
+#include "host_strip.h"
+
+/**
+ * strip exposing the incremental power sums so they can be compared to a full recalculation
+*/
+class Power_Strip : public Host_Strip
+{
+public:
+  Power_Strip(const int p_nleds) : Host_Strip(p_nleds) {}
+
+  // incremental sums equal the sums over the current raw buffer
+  bool sumsMatch()
+  {
+    if (m_led_mode != MODE::MANY || !m_leds_raw)
+      return true;
+    uint32_t sum[3] = {0, 0, 0};
+    for (uint16_t i = 0; i < m_num_leds; i++)
+    {
+      sum[0] += ledLinBrightness(m_leds_raw[i].r);
+      sum[1] += ledLinBrightness(m_leds_raw[i].g);
+      sum[2] += ledLinBrightness(m_leds_raw[i].b);
+    }
+    return CHECK_EQ(sum[0], m_power_sum[0]) && CHECK_EQ(sum[1], m_power_sum[1]) && CHECK_EQ(sum[2], m_power_sum[2]);
+  }
+
+  // current drawn by the output buffer, every channel draws milliamps_per_channel at 255
+  double measuredMilliamps()
+  {
+    uint64_t sum = 0;
+    for (uint16_t i = 0; i < m_num_leds; i++)
+      sum += (uint32_t)m_leds[i].r + m_leds[i].g + m_leds[i].b;
+    return sum * (double)m_milliamps_per_channel / 255;
+  }
+
+  /**
+   * the estimate works without the rounding of the 8 bit scaling
+   * brightness and correction scaling each move a lit channel by less than one output step
+  */
+  double roundingMilliamps()
+  {
+    uint32_t lit = 0;
+    for (uint16_t i = 0; i < m_num_leds; i++)
+    {
+      CRGB c = getRawColor(i);
+      lit += (ledLinBrightness(c.r) > 0) + (ledLinBrightness(c.g) > 0) + (ledLinBrightness(c.b) > 0);
+    }
+    return lit * 2.0 * m_milliamps_per_channel / 255;
+  }
+};
+
+// one random write through any of the public interfaces
+static void randomEdit(Power_Strip &s)
+{
+  const uint16_t n = s.getNumLeds();
+  const CRGB c(random8(), random8(), random8());
+  switch (random8(12))
+  {
+  case 0:
+  case 1:
+  case 2:
+    s.setSingleColor(c, random16() % n);
+    break;
+  case 3:
+    s.setRangeColor(c, random16() % n, random16() % n);
+    break;
+  case 4:
+  {
+    uint8_t rgb[3 * 40];
+    for (uint8_t &b : rgb)
+      b = random8();
+    s.writeRaw(random16() % n, rgb, 40);
+    break;
+  }
+  case 5:
+    s.scroll(random8() - 128);
+    break;
+  case 6:
+    s.fadeall(random8());
+    break;
+  case 7:
+    s.sparkle();
+    break;
+  case 8:
+    s.spectrumHue();
+    break;
+  case 9:
+    s.setColor(c);
+    break;
+  case 10:
+    s.setPaletteColor(random8(16), c);
+    s.setPaletteIndex(random8(16), random16() % n);
+    break;
+  case 11:
+    s.setColorCorrection(CRGB(255, 128 + random8(128), 128 + random8(128)));
+    break;
+  }
+}
+
+TEST(power_sums_match_brute_force)
+{
+  Power_Strip s(300);
+  s.begin();
+  s.setMaxMilliamps(60000); // high enough to never limit
+  random16_set_seed(7);
+  for (uint16_t k = 0; k < 3000; k++)
+  {
+    randomEdit(s);
+    if (!s.sumsMatch())
+    {
+      printf("after %u edits\n", k);
+      return;
+    }
+    s.update();
+  }
+}
+
+TEST(estimate_matches_output)
+{
+  Power_Strip s(300);
+  s.begin();
+  s.setMaxMilliamps(60000);
+  random16_set_seed(11);
+  for (uint16_t k = 0; k < 3000; k++)
+  {
+    randomEdit(s);
+    s.update();
+    double measured = s.measuredMilliamps();
+    // the estimate is truncated to whole mA
+    if (!CHECK(fabs(s.getEstimatedMilliamps() - measured) <= 0.02 * measured + s.roundingMilliamps() + 1))
+    {
+      printf("after %u edits: estimated %u mA, measured %.1f mA\n", k, s.getEstimatedMilliamps(), measured);
+      return;
+    }
+  }
+}
+
+TEST(limiter_keeps_output_within_budget)
+{
+  static const uint16_t BUDGETS[] = {500, 1500, 4000};
+  for (uint16_t budget : BUDGETS)
+  {
+    Power_Strip s(300);
+    s.begin();
+    s.setMaxMilliamps(budget);
+    random16_set_seed(budget);
+    double worst = 0;
+    for (uint16_t k = 0; k < 2000; k++)
+    {
+      randomEdit(s);
+      s.update();
+      worst = fmax(worst, s.measuredMilliamps() - budget);
+      CHECK(s.getEstimatedMilliamps() <= budget);
+      CHECK(s.measuredMilliamps() <= budget + s.roundingMilliamps());
+    }
+    printf("budget %u mA: largest overshoot %.1f mA\n", budget, worst);
+  }
+}
+
+TEST(full_white_is_limited_to_budget)
+{
+  Power_Strip s(100);
+  s.begin(CRGB::White);
+  s.setMaxMilliamps(1000); // 100 leds at full white draw 6000 mA
+  s.setColor(CRGB::White);
+  s.update();
+  CHECK(s.getEstimatedMilliamps() <= 1000);
+  CHECK(s.getEstimatedMilliamps() >= 950);
+  CHECK(s.measuredMilliamps() <= 1000);
+}
@@ -0,0 +1,120 @@
+#include "test.h"
+
+#include <PWM_Dimmable_LED_Strip.h>
+#include <PWM_RGB_LED_Strip.h>
+
+template <class STRIP>
+static void begin(STRIP &s, const CRGB &color, const uint8_t brightness)
+{
+  s.init(color, brightness, 0);
+  s.setBrightness(brightness);
+  s.setPower(true);
+}
+
+TEST(rgb_writes_only_changed_channels)
+{
+  hostPwm().reset();
+  PWM_RGB_LED_Strip s(4, 5, 12);
+  begin(s, CRGB(200, 100, 50), 255);
+  s.update();
+  CHECK_EQ(hostPwm().writes, 3);
+  CHECK_EQ(hostPwm().value[4], scaledChannel16(200, 255, 255) >> 8);
+  CHECK_EQ(hostPwm().value[5], scaledChannel16(100, 255, 255) >> 8);
+  CHECK_EQ(hostPwm().value[12], scaledChannel16(50, 255, 255) >> 8);
+
+  for (uint8_t i = 0; i < 10; i++)
+  {
+    hostAdvanceMillis(20);
+    s.update();
+  }
+  CHECK_EQ(hostPwm().writes, 3);
+
+  s.setColor(CRGB(10, 100, 50));
+  s.update();
+  CHECK_EQ(hostPwm().writes, 4);
+  CHECK_EQ(hostPwm().value[4], scaledChannel16(10, 255, 255) >> 8);
+}
+
+TEST(rgb_resolution_and_frequency)
+{
+  static const uint8_t BITS[] = {8, 10, 12, 16};
+  for (uint8_t bits : BITS)
+  {
+    hostPwm().reset();
+    PWM_RGB_LED_Strip s(4, 5, 12, bits, 1000);
+    CHECK_EQ(hostPwm().range, (1UL << bits) - 1);
+    CHECK_EQ(hostPwm().frequency, 1000);
+    CHECK_EQ(s.getPwmBits(), bits);
+
+    begin(s, CRGB(3, 128, 255), 40);
+    s.setColorCorrection(CRGB(255, 176, 240));
+    s.update();
+    CHECK_EQ(hostPwm().value[4], scaledChannel16(3, 40, 255) >> (16 - bits));
+    CHECK_EQ(hostPwm().value[5], scaledChannel16(128, 40, 176) >> (16 - bits));
+    CHECK_EQ(hostPwm().value[12], scaledChannel16(255, 40, 240) >> (16 - bits));
+  }
+}
+
+TEST(rgb_setPwm_rewrites_all_channels)
+{
+  hostPwm().reset();
+  PWM_RGB_LED_Strip s(4, 5, 12);
+  begin(s, CRGB::White, 255);
+  s.update();
+  CHECK_EQ(hostPwm().writes, 3);
+
+  s.setPwm(8, 500); // same values but the timer has been reprogrammed
+  s.update();
+  CHECK_EQ(hostPwm().writes, 6);
+  CHECK_EQ(hostPwm().frequency, 500);
+
+  // out of range resolutions are clamped
+  s.setPwm(20, 500);
+  CHECK_EQ(s.getPwmBits(), 16);
+  CHECK_EQ(hostPwm().range, 65535);
+}
+
+TEST(dimmable_8bit_matches_brightness_curve)
+{
+  hostPwm().reset();
+  PWM_Dimmable_LED_Strip s(2);
+  begin(s, CRGB::White, 0);
+  for (uint16_t bri = 0; bri < 256; bri++)
+  {
+    s.setBrightness(bri);
+    s.update();
+    if (!CHECK_EQ(hostPwm().value[2], ledLinBrightness(bri)))
+      return;
+  }
+}
+
+TEST(dimmable_fade_writes_each_step_once)
+{
+  static const uint8_t BITS[] = {8, 12};
+  uint32_t writes[2];
+  for (uint8_t k = 0; k < 2; k++)
+  {
+    hostPwm().reset();
+    PWM_Dimmable_LED_Strip s(2, BITS[k]);
+    begin(s, CRGB::White, 0);
+    s.setTransitionTime(2000);
+    s.setBrightness(255);
+    int32_t last = -1;
+    uint32_t steps = 0;
+    for (uint16_t t = 0; t <= 2100; t++)
+    {
+      s.update();
+      hostAdvanceMillis(1);
+      int32_t v = hostPwm().value[2];
+      CHECK(v >= last); // brightness only rises
+      steps += v != last;
+      last = v;
+    }
+    CHECK_EQ(last, ledLinBrightness_16bit(255 << 8) >> (16 - BITS[k]));
+    CHECK_EQ(hostPwm().writes, steps); // every write changed the output
+    writes[k] = steps;
+  }
+  // 8 bit output merges the flat start of the brightness curve, higher resolutions keep every step
+  printf("fade steps: 8 bit %u, 12 bit %u\n", writes[0], writes[1]);
+  CHECK(writes[1] > writes[0]);
+}
@@ -0,0 +1,207 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <stdlib.h>
+#include <vector>
+
+/**
+ * count live heap bytes so getHeapUsage() can be compared to real allocations
+ * every block carries its size in front of the returned pointer
+*/
+static size_t heap_live = 0;
+static const size_t HEAP_HEADER = 16;
+
+static void *heapAlloc(size_t n)
+{
+  size_t *block = (size_t *)malloc(n + HEAP_HEADER);
+  if (!block)
+    abort();
+  block[0] = n;
+  heap_live += n;
+  return (char *)block + HEAP_HEADER;
+}
+
+static void heapFree(void *p)
+{
+  if (!p)
+    return;
+  size_t *block = (size_t *)((char *)p - HEAP_HEADER);
+  heap_live -= block[0];
+  free(block);
+}
+
+void *operator new(size_t n) { return heapAlloc(n); }
+void *operator new[](size_t n) { return heapAlloc(n); }
+void operator delete(void *p) noexcept { heapFree(p); }
+void operator delete[](void *p) noexcept { heapFree(p); }
+void operator delete(void *p, size_t) noexcept { heapFree(p); }
+void operator delete[](void *p, size_t) noexcept { heapFree(p); }
+
+// print one line of the heap report and compare it to the allocations since base
+static bool heapReport(const char *state, Host_Strip &s, const size_t base)
+{
+  printf("heap: %-26s leds: %4u reported: %6zu allocated: %6zu\n", state, s.getNumLeds(), s.getHeapUsage(), heap_live - base);
+  return CHECK_EQ(s.getHeapUsage(), heap_live - base);
+}
+
+TEST(heap_usage_matches_allocations)
+{
+  const uint16_t n = 300;
+  size_t base = heap_live;
+  Host_Strip *s = new Host_Strip(n);
+  base += sizeof(Host_Strip);
+  s->begin();
+
+  s->setColor(CRGB::Red);
+  s->update();
+  heapReport("SINGLE", *s, base);
+  CHECK_EQ(s->getHeapUsage(), n * 3);
+
+  s->setSingleColor(CRGB::Blue, 7);
+  s->update();
+  heapReport("MANY", *s, base);
+  CHECK_EQ(s->getHeapUsage(), n * 6);
+
+  s->beginCrossfade(100);
+  heapReport("MANY + crossfade", *s, base);
+  CHECK_EQ(s->getHeapUsage(), n * 9);
+
+  s->setDither(true);
+  s->update();
+  heapReport("MANY + crossfade + dither", *s, base);
+
+  s->setPaletteIndex(3, 5);
+  s->update();
+  heapReport("PALETTE", *s, base);
+
+  delete s;
+  CHECK_EQ(heap_live, base - sizeof(Host_Strip));
+}
+
+TEST(single_mode_allocates_no_raw_buffer)
+{
+  size_t base = heap_live;
+  Host_Strip s(1000);
+  s.begin();
+  s.setColor(CRGB(10, 20, 30));
+  s.update();
+  s.setColor(CRGB(30, 20, 10));
+  s.update();
+  CHECK_EQ(heap_live - base, 1000 * 3);
+}
+
+TEST(crossfade_starts_from_single_color)
+{
+  Host_Strip s(10);
+  s.begin();
+  s.setSingleColor(CRGB::Red, 3);
+  s.update();
+  s.setColor(CRGB::Blue);
+  s.update();
+
+  // raw buffer still holds the red led, the visible frame is all blue
+  s.beginCrossfade(1000);
+  s.setSingleColor(CRGB::Blue, 3);
+  s.update();
+  for (uint16_t i = 0; i < 10; i++)
+    CHECK_COLOR(s.out(i), scaledColor(CRGB::Blue, 255, CRGB(0xFFFFFF)));
+}
+
+TEST(crossfade_blends_to_new_frame)
+{
+  Host_Strip s(4);
+  s.begin();
+  s.setMode(LED_Strip::MODE::MANY);
+  for (uint16_t i = 0; i < 4; i++)
+    s.setSingleColor(CRGB(200, 0, 0), i);
+  s.update();
+
+  s.beginCrossfade(1000);
+  for (uint16_t i = 0; i < 4; i++)
+    s.setSingleColor(CRGB(0, 0, 200), i);
+
+  hostAdvanceMillis(500);
+  s.update();
+  CHECK_COLOR(s.out(0), scaledColor(CRGB(100, 0, 100), 255, CRGB(0xFFFFFF)));
+
+  hostAdvanceMillis(500);
+  s.update();
+  CHECK(!s.isCrossfading());
+  CHECK_COLOR(s.out(0), scaledColor(CRGB(0, 0, 200), 255, CRGB(0xFFFFFF)));
+}
+
+// without a raw frame nothing is blended, the crossfade still has to finish
+TEST(crossfade_finishes_without_raw_frame)
+{
+  Host_Strip s(10);
+  s.begin();
+  s.beginCrossfade(100);
+  for (uint8_t f = 0; f < 50 && s.isCrossfading(); f++)
+  {
+    hostAdvanceMillis(10);
+    s.update();
+  }
+  CHECK(!s.isCrossfading());
+  CHECK_EQ(s.nextUpdateDue(), LED_Strip::NEVER);
+
+  s.setDither(true);
+  s.beginCrossfade(100);
+  hostAdvanceMillis(100);
+  s.update();
+  CHECK(!s.isCrossfading());
+}
+
+// leaving palette mode keeps every led at its palette color
+static void checkPaletteExpanded(Host_Strip &s, const CRGB *colors, const uint8_t *index, const std::vector<CRGB> &shown, const uint16_t skip)
+{
+  s.update();
+  for (uint16_t i = 0; i < s.getNumLeds(); i++)
+  {
+    if (i == skip)
+      continue;
+    CHECK_COLOR(s.getRawColor(i), colors[index[i]]);
+    CHECK_COLOR(s.out(i), shown[i]);
+  }
+}
+
+TEST(palette_expands_into_new_raw_buffer)
+{
+  const uint16_t n = 30;
+  const CRGB colors[3] = {CRGB(200, 0, 0), CRGB(0, 150, 0), CRGB(10, 20, 30)};
+  uint8_t index[n];
+  Host_Strip s(n);
+  s.begin(CRGB(1, 1, 1));
+  s.setPalette(colors, 3);
+  for (uint16_t i = 0; i < n; i++)
+    s.setPaletteIndex(index[i] = i % 3, i);
+  s.update();
+  std::vector<CRGB> shown(s.outputBuffer(), s.outputBuffer() + n);
+
+  size_t base = heap_live;
+  s.setSingleColor(CRGB::White, 4); // allocates the raw buffer
+  CHECK_EQ(heap_live - base, n * 3);
+  CHECK_EQ(s.getMode(), LED_Strip::MODE::MANY);
+  checkPaletteExpanded(s, colors, index, shown, 4);
+  CHECK_COLOR(s.getRawColor(4), CRGB::White);
+}
+
+TEST(palette_expands_into_existing_raw_buffer)
+{
+  const uint16_t n = 30;
+  const CRGB colors[2] = {CRGB(0, 0, 90), CRGB(70, 70, 0)};
+  uint8_t index[n];
+  Host_Strip s(n);
+  s.begin();
+  s.setSingleColor(CRGB::Red, 0); // raw buffer holds stale data from here on
+  s.setPalette(colors, 2);
+  for (uint16_t i = 0; i < n; i++)
+    s.setPaletteIndex(i < 10, i);
+  s.scroll(7); // index ring is rotated
+  for (uint16_t i = 0; i < n; i++)
+    index[i] = s.getPaletteIndex(i);
+  s.update();
+  std::vector<CRGB> shown(s.outputBuffer(), s.outputBuffer() + n);
+
+  s.setMode(LED_Strip::MODE::MANY);
+  checkPaletteExpanded(s, colors, index, shown, n);
+}
@@ -0,0 +1,32 @@
+#include "test.h"
+
+#include <led_helper.h>
+
+static const CRGB CORRECTIONS[] = {CRGB(255, 255, 255), CRGB(255, 176, 240), CRGB(0, 1, 128), CRGB(255, 147, 41)};
+
+TEST(table_matches_scaledColor_exhaustively)
+{
+  ScaledColorTable table;
+  for (const CRGB &corr : CORRECTIONS)
+  {
+    for (uint16_t bri = 0; bri < 256; bri++)
+    {
+      table.update(bri, corr);
+      for (uint16_t x = 0; x < 256; x++)
+      {
+        CRGB c(x, 255 - x, x ^ 0x5A);
+        if (!CHECK_COLOR(table.scale(c), scaledColor(c, bri, corr)))
+          return;
+      }
+    }
+  }
+}
+
+TEST(table_is_only_rebuilt_on_change)
+{
+  ScaledColorTable table;
+  CHECK(table.update(100, CRGB(255, 176, 240)));
+  CHECK(!table.update(100, CRGB(255, 176, 240)));
+  CHECK(table.update(101, CRGB(255, 176, 240)));
+  CHECK(table.update(101, CRGB(255, 176, 241)));
+}
@@ -0,0 +1,148 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <LED_Scheduler.h>
+
+/**
+ * strip whose show() takes time, every frame changes one led so each run() renders
+*/
+class Slow_Strip : public Host_Strip
+{
+public:
+  uint32_t show_time = 0; // us
+
+  Slow_Strip(const int p_nleds) : Host_Strip(p_nleds) {}
+
+  void show() override
+  {
+    Host_Strip::show();
+    hostAdvanceMicros(show_time);
+  }
+
+  void change()
+  {
+    setSingleColor(CRGB(shows, 1, 1), 0);
+  }
+};
+
+// start the clock shortly before the 32 bit micros() counter wraps
+static void startBeforeWrap(const uint32_t us)
+{
+  hostSetMillis(0);
+  hostAdvanceMicros(UINT32_MAX - us + 1);
+}
+
+TEST(scheduler_cadence_across_micros_wrap)
+{
+  startBeforeWrap(50000);
+  Slow_Strip s(4);
+  s.begin();
+  LED_Scheduler<> scheduler(100);
+  CHECK(scheduler.add(s));
+
+  uint32_t last = micros();
+  s.change();
+  CHECK(scheduler.run()); // the first frame starts immediately
+  uint32_t frames = 1;
+  for (uint16_t t = 0; t < 200; t++)
+  {
+    hostAdvanceMicros(1000);
+    s.change();
+    if (scheduler.run())
+    {
+      CHECK_EQ((uint32_t)(micros() - last), 10000);
+      last = micros();
+      frames++;
+    }
+  }
+  CHECK(micros() < 200000); // wrapped
+  CHECK_EQ(frames, 21);
+  CHECK_EQ(s.shows, 21);
+
+  const auto &stats = scheduler.getStats();
+  CHECK_EQ(stats.frames, 21);
+  CHECK_EQ(stats.skipped, 0);
+  CHECK_EQ(stats.overruns, 0);
+  CHECK_EQ(stats.jitter_min, 0);
+  CHECK_EQ(stats.jitter_max, 0);
+  CHECK_EQ(stats.jitter_avg, 0);
+}
+
+TEST(scheduler_skips_late_frames)
+{
+  startBeforeWrap(20000);
+  Slow_Strip s(4);
+  s.begin();
+  LED_Scheduler<> scheduler(100);
+  scheduler.add(s);
+  CHECK(scheduler.run());
+  CHECK(!scheduler.run()); // not due yet
+  CHECK_EQ(scheduler.timeUntilNextFrame(), 10000);
+
+  // 2.5 frames late across the wrap: 2 frames are dropped, the third is rendered 5 ms late
+  hostAdvanceMicros(35000);
+  s.change();
+  CHECK(scheduler.run());
+  CHECK_EQ(scheduler.getStats().skipped, 2);
+  CHECK_EQ(scheduler.getStats().jitter_max, 5000);
+  CHECK_EQ(scheduler.timeUntilNextFrame(), 5000); // back on the original grid
+
+  hostAdvanceMicros(5000);
+  CHECK(scheduler.run());
+  const auto &stats = scheduler.getStats();
+  CHECK_EQ(stats.frames, 3);
+  CHECK_EQ(stats.skipped, 2);
+  CHECK_EQ(stats.jitter_min, 0);
+  CHECK_EQ(stats.jitter_avg, 5000 / 16 - (5000 / 16) / 16); // moving average of 0, 5000, 0
+
+  scheduler.resetStats();
+  CHECK_EQ(scheduler.getStats().frames, 0);
+  CHECK_EQ(scheduler.getStats().skipped, 0);
+}
+
+TEST(scheduler_counts_overruns)
+{
+  startBeforeWrap(5000);
+  Slow_Strip s(4);
+  s.begin();
+  s.show_time = 12000;
+  LED_Scheduler<> scheduler(100);
+  scheduler.add(s);
+
+  s.change();
+  CHECK(scheduler.run());
+  CHECK_EQ(scheduler.getStats().overruns, 1);
+  CHECK_EQ(scheduler.getStats().render_max, 12000);
+
+  // the next frame is 2 ms late but not skipped, a static strip renders in no time
+  CHECK(scheduler.run());
+  CHECK_EQ(scheduler.getStats().skipped, 0);
+  CHECK_EQ(scheduler.getStats().overruns, 1);
+  CHECK_EQ(scheduler.getStats().jitter_max, 2000);
+  CHECK_EQ(scheduler.getStats().frames, 2);
+}
+
+TEST(scheduler_next_update_due)
+{
+  startBeforeWrap(3000);
+  Slow_Strip a(4), b(4);
+  a.begin();
+  b.begin();
+  LED_Scheduler<2> scheduler(100);
+  CHECK(scheduler.add(a));
+  CHECK(scheduler.add(b));
+  CHECK(!scheduler.add(a)); // full
+  CHECK(scheduler.run());
+  CHECK_EQ(scheduler.nextUpdateDue(), LED_Strip::NEVER); // all strips static
+
+  // a change is rendered with the next frame, rounded up to whole ms
+  b.change();
+  CHECK_EQ(scheduler.nextUpdateDue(), 10);
+  hostAdvanceMicros(2500);
+  CHECK_EQ(scheduler.nextUpdateDue(), 8);
+  hostAdvanceMicros(7500);
+  CHECK_EQ(scheduler.nextUpdateDue(), 0);
+  CHECK(scheduler.run());
+  CHECK_EQ(b.shows, 2);
+  CHECK_EQ(scheduler.nextUpdateDue(), LED_Strip::NEVER);
+}
@@ -0,0 +1,133 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <LED_Segment.h>
+
+/**
+ * parent strip whose output buffer can be overwritten to see which leds are rendered again
+*/
+class Probe_Strip : public Host_Strip
+{
+public:
+  Probe_Strip(const int p_nleds) : Host_Strip(p_nleds) {}
+
+  inline void poke(const uint16_t i, const CRGB &c)
+  {
+    m_leds[i] = c;
+  }
+};
+
+static const CRGB RED = scaledColor(CRGB::Red, 255, CRGB(0xFFFFFF));
+static const CRGB BLUE = scaledColor(CRGB::Blue, 255, CRGB(0xFFFFFF));
+
+static void beginSegment(LED_Segment &s)
+{
+  s.init(CRGB::Black, 255, 0);
+  s.setBrightness(255);
+  s.setPower(true);
+}
+
+TEST(segment_clamped_to_parent_end)
+{
+  Probe_Strip parent(20);
+  parent.begin();
+  {
+    LED_Segment a(parent, 15, 10);
+    beginSegment(a);
+    CHECK_EQ(a.getNumLeds(), 5);
+    a.setColor(CRGB::Red);
+    parent.update();
+    for (uint16_t i = 0; i < 20; i++)
+      CHECK_COLOR(parent.out(i), i < 15 ? CRGB(0) : RED);
+  }
+  {
+    // offset past the end -> the last led of the parent
+    LED_Segment b(parent, 30, 4);
+    beginSegment(b);
+    CHECK_EQ(b.getNumLeds(), 1);
+    b.setColor(CRGB::Blue);
+    parent.update();
+    CHECK_COLOR(parent.out(18), RED);
+    CHECK_COLOR(parent.out(19), BLUE);
+  }
+}
+
+TEST(segment_reversed_output)
+{
+  Probe_Strip parent(10);
+  parent.begin();
+  LED_Segment r(parent, 2, 5, true);
+  beginSegment(r);
+  r.setSingleColor(CRGB::Red, 0);
+  r.setSingleColor(CRGB::Blue, 4);
+  parent.update();
+  CHECK_COLOR(parent.out(6), RED);
+  CHECK_COLOR(parent.out(2), BLUE);
+  CHECK_COLOR(r.getRawColor(0), CRGB::Red);
+  for (uint16_t i : {0, 1, 3, 4, 5, 7, 8, 9})
+    CHECK_COLOR(parent.out(i), CRGB(0));
+
+  // a single led change is written to the mirrored position only
+  parent.poke(3, CRGB(1, 2, 3));
+  r.setSingleColor(CRGB::Red, 1);
+  parent.update();
+  CHECK_COLOR(parent.out(5), RED);
+  CHECK_COLOR(parent.out(3), CRGB(1, 2, 3));
+}
+
+TEST(segment_only_changed_segments_render)
+{
+  Probe_Strip parent(30);
+  parent.begin();
+  LED_Segment a(parent, 0, 10), b(parent, 10, 10), c(parent, 20, 10);
+  for (LED_Segment *s : {&a, &b, &c})
+  {
+    beginSegment(*s);
+    s->setColor(CRGB::Blue);
+  }
+  parent.update();
+
+  // leds of unchanged segments are not written again
+  parent.poke(5, CRGB(1, 2, 3));
+  parent.poke(25, CRGB(1, 2, 3));
+  b.setColor(CRGB::Red);
+  CHECK_EQ(parent.nextUpdateDue(), 0);
+  CHECK(parent.render());
+  CHECK_COLOR(parent.out(5), CRGB(1, 2, 3));
+  CHECK_COLOR(parent.out(25), CRGB(1, 2, 3));
+  for (uint16_t i = 10; i < 20; i++)
+    CHECK_COLOR(parent.out(i), RED);
+
+  CHECK(!parent.render());
+  CHECK_EQ(parent.nextUpdateDue(), LED_Strip::NEVER);
+}
+
+TEST(segment_parent_shows_once_per_frame)
+{
+  Probe_Strip parent(30);
+  parent.begin();
+  LED_Segment a(parent, 0, 10), b(parent, 10, 10), c(parent, 20, 10);
+  for (LED_Segment *s : {&a, &b, &c})
+    beginSegment(*s);
+  parent.update();
+  uint32_t shows = parent.shows;
+
+  for (uint8_t f = 1; f <= 3; f++)
+  {
+    a.setColor(CRGB(f * 50, 0, 0));
+    b.setColor(CRGB(0, f * 50, 0));
+    c.setColor(CRGB(0, 0, f * 50));
+    parent.update();
+    CHECK_EQ(parent.shows, shows + f);
+  }
+
+  // segments only render, the hardware is written with the next frame of the parent
+  a.setColor(CRGB::White);
+  a.update();
+  CHECK_EQ(parent.shows, shows + 3);
+  CHECK_EQ(parent.nextUpdateDue(), 0);
+  parent.update();
+  CHECK_EQ(parent.shows, shows + 4);
+  parent.update(); // nothing changed
+  CHECK_EQ(parent.shows, shows + 4);
+}
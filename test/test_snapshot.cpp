@@ -0,0 +1,252 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <stdio.h>
+#include <vector>
+
+/**
+ * snapshot store backed by a temporary file like a flash file system on the device
+*/
+class File_Stream : public Stream
+{
+protected:
+  FILE *m_file;
+
+public:
+  File_Stream() : m_file(tmpfile()) {}
+  ~File_Stream() { fclose(m_file); }
+
+  size_t write(uint8_t c) override
+  {
+    return fputc(c, m_file) == EOF ? 0 : 1;
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    return fwrite(buffer, 1, size, m_file);
+  }
+
+  int available() override
+  {
+    long pos = ftell(m_file);
+    fseek(m_file, 0, SEEK_END);
+    long end = ftell(m_file);
+    fseek(m_file, pos, SEEK_SET);
+    return end - pos;
+  }
+
+  int read() override
+  {
+    return fgetc(m_file);
+  }
+
+  int peek() override
+  {
+    int c = fgetc(m_file);
+    if (c != EOF)
+      ungetc(c, m_file);
+    return c;
+  }
+
+  // start reading from the beginning
+  void rewind()
+  {
+    fflush(m_file);
+    ::rewind(m_file);
+  }
+
+  // overwrite byte at pos, the read position is reset
+  void patch(const long pos, const uint8_t c)
+  {
+    fseek(m_file, pos, SEEK_SET);
+    fputc(c, m_file);
+    rewind();
+  }
+
+  // cut the file after n bytes
+  void truncate(const long n)
+  {
+    std::vector<uint8_t> data(n);
+    rewind();
+    fread(data.data(), 1, n, m_file);
+    fclose(m_file);
+    m_file = tmpfile();
+    write(data.data(), n);
+    rewind();
+  }
+};
+
+// save a, restore into b and compare the rendered output
+static bool roundTrip(Host_Strip &a, Host_Strip &b, size_t *bytes = nullptr)
+{
+  File_Stream file;
+  size_t n = a.saveState(file);
+  if (bytes)
+    *bytes = n;
+  file.rewind();
+  CHECK_EQ(file.available(), n);
+  if (!CHECK(b.restoreState(file)))
+    return false;
+
+  a.render();
+  b.render();
+  bool ok = CHECK_EQ(a.getPower(), b.getPower()) && CHECK_EQ(a.getBrightness(), b.getBrightness());
+  for (uint16_t i = 0; i < a.getNumLeds(); i++)
+    ok = CHECK_COLOR(b.out(i), a.out(i)) && ok;
+  return ok;
+}
+
+TEST(snapshot_single)
+{
+  Host_Strip a(50), b(50);
+  a.begin();
+  b.begin();
+  a.setColor(CRGB(200, 100, 30));
+  a.setBrightness(180);
+  size_t bytes;
+  roundTrip(a, b, &bytes);
+  CHECK_EQ(b.getMode(), LED_Strip::MODE::SINGLE);
+  CHECK_EQ(bytes, 15 + 2); // no pixels in single mode
+}
+
+TEST(snapshot_many)
+{
+  const uint16_t n = 300;
+  Host_Strip a(n), b(n);
+  a.begin();
+  b.begin(CRGB(1, 2, 3));
+  for (uint16_t i = 0; i < n; i++)
+    a.setSingleColor(i < 100 ? CRGB::Red : CRGB(i, 255 - i, i * 7), i);
+  size_t bytes;
+  roundTrip(a, b, &bytes);
+  CHECK_EQ(b.getMode(), LED_Strip::MODE::MANY);
+  // the red run codes in a few bytes, the rest is literal
+  CHECK(bytes < 15 + n * 3 + 2);
+  CHECK(bytes > 15 + 200 * 3 + 2);
+}
+
+TEST(snapshot_uniform_many_is_small)
+{
+  const uint16_t n = 1000;
+  Host_Strip a(n), b(n);
+  a.begin();
+  b.begin();
+  for (uint16_t i = 0; i < n; i++)
+    a.setSingleColor(CRGB(40, 50, 60), i);
+  size_t bytes;
+  roundTrip(a, b, &bytes);
+  printf("snapshot: %u uniform leds in %zu bytes\n", n, bytes);
+  CHECK(bytes < 15 + 64 + 2);
+}
+
+TEST(snapshot_scrolled)
+{
+  const uint16_t n = 64;
+  Host_Strip a(n), b(n);
+  a.begin();
+  b.begin();
+  for (uint16_t i = 0; i < n; i++)
+    a.setSingleColor(CRGB(i * 4, 0, 255 - i * 4), i);
+  a.scroll(5);
+  a.scroll(-17);
+  roundTrip(a, b);
+}
+
+TEST(snapshot_palette)
+{
+  const uint16_t n = 120;
+  Host_Strip a(n), b(n);
+  a.begin();
+  b.begin();
+  const CRGB colors[3] = {CRGB::Red, CRGB::Green, CRGB(10, 20, 30)};
+  a.setPalette(colors, 3);
+  for (uint16_t i = 0; i < n; i++)
+    a.setPaletteIndex(i % 3, i);
+  roundTrip(a, b);
+  CHECK_EQ(b.getMode(), LED_Strip::MODE::MANY); // palette is stored as pixels
+}
+
+// strip with all leds at (7, 7, 7) rendered once, the reference for rejected snapshots
+static void fillGrey(Host_Strip &s)
+{
+  s.begin();
+  for (uint16_t i = 0; i < s.getNumLeds(); i++)
+    s.setSingleColor(CRGB(7, 7, 7), i);
+  s.render();
+}
+
+static bool untouched(Host_Strip &s)
+{
+  Host_Strip ref(s.getNumLeds());
+  fillGrey(ref);
+  s.render();
+  bool ok = CHECK_EQ(s.getMode(), LED_Strip::MODE::MANY);
+  for (uint16_t i = 0; i < s.getNumLeds(); i++)
+    ok = ok && CHECK_COLOR(s.out(i), ref.out(i));
+  return ok;
+}
+
+TEST(snapshot_corrupt_is_rejected)
+{
+  const uint16_t n = 80;
+  Host_Strip a(n);
+  a.begin();
+  for (uint16_t i = 0; i < n; i++)
+    a.setSingleColor(CRGB(i, 100, 200), i);
+  File_Stream file;
+  size_t bytes = a.saveState(file);
+  std::vector<uint8_t> data(bytes);
+  file.rewind();
+  file.readBytes(data.data(), bytes);
+
+  // flip one bit in every byte of the pixel data and the checksum
+  for (size_t pos = 15; pos < bytes; pos++)
+  {
+    file.patch(pos, data[pos] ^ 0x10);
+    Host_Strip b(n);
+    fillGrey(b);
+    CHECK(!b.restoreState(file));
+    if (!untouched(b))
+      printf("corrupt byte %zu\n", pos);
+    file.patch(pos, data[pos]);
+  }
+
+  Host_Strip b(n);
+  fillGrey(b);
+  CHECK(b.restoreState(file)); // unmodified copy still restores
+}
+
+TEST(snapshot_wrong_length_is_rejected)
+{
+  Host_Strip a(40), b(41);
+  a.begin();
+  a.setSingleColor(CRGB::Blue, 3);
+  fillGrey(b);
+  File_Stream file;
+  a.saveState(file);
+  file.rewind();
+  CHECK(!b.restoreState(file));
+  untouched(b);
+}
+
+TEST(snapshot_truncated_is_rejected)
+{
+  const uint16_t n = 40;
+  Host_Strip a(n);
+  a.begin();
+  for (uint16_t i = 0; i < n; i++)
+    a.setSingleColor(CRGB(i * 5, 1, 2), i);
+  File_Stream full;
+  size_t bytes = a.saveState(full);
+
+  for (size_t cut = 0; cut < bytes; cut += 7)
+  {
+    File_Stream file;
+    a.saveState(file);
+    file.truncate(cut);
+    Host_Strip b(n);
+    fillGrey(b);
+    CHECK(!b.restoreState(file));
+    untouched(b);
+  }
+}
@@ -0,0 +1,117 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <string>
+
+#if !LED_STRIP_STATS
+#error "test_stats is built with LED_STRIP_STATS=1"
+#endif
+
+/**
+ * strip whose output takes time, optionally with interrupts disabled
+*/
+class Timed_Strip : public Host_Strip
+{
+public:
+  uint32_t show_time = 0; // us
+  bool blocking = false;
+
+  Timed_Strip(const int p_nleds) : Host_Strip(p_nleds) {}
+
+  void show() override
+  {
+    Host_Strip::show();
+    hostAdvanceMicros(show_time);
+  }
+
+  bool isOutputBlocking() override
+  {
+    return blocking;
+  }
+};
+
+class String_Print : public Print
+{
+public:
+  std::string text;
+
+  size_t write(uint8_t c) override
+  {
+    text += (char)c;
+    return 1;
+  }
+};
+
+TEST(stats_count_frames_and_pixels)
+{
+  Timed_Strip s(100);
+  s.begin();
+  s.setMode(LED_Strip::MODE::MANY);
+  s.setSingleColor(CRGB::Black, 0); // allocates the raw buffer
+  s.update();
+  s.resetStats();
+  CHECK_EQ(s.getStats().frames_rendered, 0);
+  CHECK_EQ(s.getStats().render_time.count, 0);
+
+  // only the dirty range is recomputed
+  s.setSingleColor(CRGB::Red, 10);
+  s.setSingleColor(CRGB::Red, 12);
+  s.update();
+  CHECK_EQ(s.getStats().frames_rendered, 1);
+  CHECK_EQ(s.getStats().frames_skipped, 0);
+  CHECK_EQ(s.getStats().pixels_recomputed, 3);
+
+  // nothing changed
+  s.update();
+  s.update();
+  CHECK_EQ(s.getStats().frames_rendered, 1);
+  CHECK_EQ(s.getStats().frames_skipped, 2);
+  CHECK_EQ(s.getStats().pixels_recomputed, 3);
+
+  // a mode switch recomputes every led
+  s.setMode(LED_Strip::MODE::SINGLE);
+  s.setColor(CRGB::Blue);
+  s.update();
+  CHECK_EQ(s.getStats().frames_rendered, 2);
+  CHECK_EQ(s.getStats().pixels_recomputed, 103);
+
+  // every render is timed, the host clock does not run while rendering
+  const LED_Timing &render = s.getStats().render_time;
+  CHECK_EQ(render.count, 4);
+  CHECK_EQ(render.max, 0);
+  CHECK_EQ(s.getStats().output_time.count, s.shows - 1);
+}
+
+TEST(stats_output_timing)
+{
+  Timed_Strip s(10);
+  s.begin();
+  s.resetStats();
+  s.show_time = 250;
+  for (uint8_t k = 1; k <= 3; k++)
+  {
+    s.setColor(CRGB(k * 50, 0, 0));
+    s.update();
+  }
+  const LED_Strip_Stats &stats = s.getStats();
+  CHECK_EQ(stats.output_time.count, 3);
+  CHECK_EQ(stats.output_time.min, 250);
+  CHECK_EQ(stats.output_time.avg, 250);
+  CHECK_EQ(stats.output_time.max, 250);
+  CHECK_EQ(stats.irq_off_max, 0); // output with interrupts enabled
+
+  s.blocking = true;
+  s.show_time = 410;
+  s.setColor(CRGB::Green);
+  s.update();
+  CHECK_EQ(stats.output_time.min, 250);
+  CHECK_EQ(stats.output_time.avg, 250 + 160 / 16);
+  CHECK_EQ(stats.output_time.max, 410);
+  CHECK_EQ(stats.irq_off_max, 410);
+
+  String_Print p;
+  size_t size = p.print(stats);
+  CHECK_EQ(size, p.text.size());
+  CHECK(p.text == "frames:4 skipped:0 pixels:40 render:0/0/0us output:250/260/410us irq_off:410us");
+  printf("%s\n", p.text.c_str());
+}
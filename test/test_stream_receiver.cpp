@@ -0,0 +1,169 @@
+#include "test.h"
+#include "host_strip.h"
+#include "host_udp.h"
+#include "stream_packets.h"
+
+#include <LED_Stream_Receiver.h>
+
+#include <chrono>
+#include <thread>
+
+static bool handle(LED_Stream_Receiver &r, const Packet &p)
+{
+  return r.handlePacket(p.data(), p.size());
+}
+
+static std::vector<uint8_t> pattern(const uint16_t num_leds, const uint8_t seed)
+{
+  std::vector<uint8_t> rgb(num_leds * 3);
+  for (size_t i = 0; i < rgb.size(); i++)
+    rgb[i] = i * 7 + seed;
+  return rgb;
+}
+
+static bool checkFrame(Host_Strip &s, const std::vector<uint8_t> &rgb)
+{
+  for (uint16_t i = 0; i < s.getNumLeds(); i++)
+  {
+    if (!CHECK_COLOR(s.getRawColor(i), CRGB(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2])))
+      return false;
+  }
+  return true;
+}
+
+TEST(ddp_frame_completes_on_push)
+{
+  Host_Strip s(400);
+  s.begin();
+  LED_Stream_Receiver r(s);
+
+  const uint8_t a[] = {1, 2, 3, 4, 5, 6};
+  const uint8_t b[] = {7, 8, 9};
+  CHECK(handle(r, ddpPacket(0, 1, 0, a, 6)));
+  CHECK(!r.available());
+  CHECK(handle(r, ddpPacket(1, 2, 6, b, 3)));
+  CHECK(r.available());
+  CHECK(!r.available());
+  CHECK_COLOR(s.getRawColor(1), CRGB(4, 5, 6));
+  CHECK_COLOR(s.getRawColor(2), CRGB(7, 8, 9));
+}
+
+TEST(ddp_sequence_counts_dropped_and_late)
+{
+  Host_Strip s(10);
+  s.begin();
+  LED_Stream_Receiver r(s);
+  const uint8_t px[] = {1, 1, 1};
+  handle(r, ddpPacket(1, 2, 0, px, 3));
+  handle(r, ddpPacket(1, 5, 0, px, 3));
+  CHECK_EQ(r.getStats().dropped, 2);
+  CHECK(!handle(r, ddpPacket(1, 3, 0, px, 3)));
+  CHECK_EQ(r.getStats().late, 1);
+}
+
+TEST(ddp_writes_scrolled_ring_buffer)
+{
+  Host_Strip s(400);
+  s.begin();
+  s.setSingleColor(CRGB::Red, 0);
+  s.scroll(5);
+  LED_Stream_Receiver r(s);
+
+  std::vector<uint8_t> px = pattern(10, 10);
+  handle(r, ddpPacket(1, 0, 395 * 3, px.data(), px.size()));
+  for (uint16_t i = 0; i < 5; i++)
+    CHECK_COLOR(s.getRawColor(395 + i), CRGB(px[i * 3], px[i * 3 + 1], px[i * 3 + 2]));
+}
+
+TEST(e131_frame_completes_on_last_universe_or_sync)
+{
+  Host_Strip s(400);
+  s.begin();
+  LED_Stream_Receiver r(s);
+
+  std::vector<uint8_t> u(510, 9), last(180, 7);
+  CHECK(handle(r, e131Packet(1, 0, 0, u.data(), u.size())));
+  CHECK(!r.available());
+  handle(r, e131Packet(2, 0, 0, u.data(), u.size()));
+  CHECK(!r.available());
+  handle(r, e131Packet(3, 0, 0, last.data(), last.size()));
+  CHECK(r.available());
+  CHECK_COLOR(s.getRawColor(339), CRGB(9, 9, 9));
+  CHECK_COLOR(s.getRawColor(340), CRGB(7, 7, 7));
+
+  // with a sync address the frame waits for the sync packet
+  handle(r, e131Packet(1, 1, 999, u.data(), u.size()));
+  handle(r, e131Packet(3, 1, 999, u.data(), u.size()));
+  CHECK(!r.available());
+  handle(r, e131Sync(999));
+  CHECK(r.available());
+
+  // old sequence number is discarded
+  CHECK(!handle(r, e131Packet(1, 0, 0, u.data(), u.size())));
+}
+
+TEST(invalid_packets_are_counted)
+{
+  Host_Strip s(10);
+  s.begin();
+  LED_Stream_Receiver r(s);
+  const uint8_t junk[5] = {1};
+  CHECK(!r.handlePacket(junk, 5));
+  Packet bad = e131Sync(1);
+  bad[4] = 'X';
+  CHECK(!handle(r, bad));
+  CHECK_EQ(r.getStats().invalid, 2);
+}
+
+/**
+ * send frames over a loopback socket and poll them like on the device
+ * @returns number of completed frames
+*/
+static uint32_t loopback(const bool e131, Host_Strip &s, const uint8_t frames)
+{
+  Host_UDP rx, tx;
+  if (!CHECK(rx.begin(0)))
+    return 0;
+  const uint16_t port = rx.localPort();
+  LED_Stream_Receiver r(s);
+
+  uint8_t seq = 0;
+  uint32_t complete = 0;
+  for (uint8_t f = 0; f < frames; f++)
+  {
+    std::vector<uint8_t> rgb = pattern(s.getNumLeds(), f);
+    for (const Packet &p : framePackets(e131, rgb.data(), s.getNumLeds(), seq))
+      CHECK(tx.send("127.0.0.1", port, p.data(), p.size()));
+
+    // loopback delivery is fast but not synchronous
+    bool done = false;
+    for (uint16_t wait = 0; wait < 1000 && !done; wait++)
+    {
+      while (r.poll(rx))
+        ;
+      done = r.available();
+      if (!done)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    if (!CHECK(done) || !checkFrame(s, rgb))
+      break;
+    complete++;
+  }
+  CHECK_EQ(r.getStats().dropped, 0);
+  CHECK_EQ(r.getStats().invalid, 0);
+  return complete;
+}
+
+TEST(ddp_loopback)
+{
+  Host_Strip s(1000); // three packets per frame
+  s.begin();
+  CHECK_EQ(loopback(false, s, 20), 20);
+}
+
+TEST(e131_loopback)
+{
+  Host_Strip s(1000); // six universes per frame
+  s.begin();
+  CHECK_EQ(loopback(true, s, 20), 20);
+}
@@ -0,0 +1,64 @@
+#include "test.h"
+#include "host_strip.h"
+
+TEST(single_mode_renders_scaled_color)
+{
+  Host_Strip s(10);
+  s.begin(CRGB::Black, 200);
+  s.setColor(CRGB(255, 100, 3));
+  s.update();
+
+  CRGB expected = scaledColor(CRGB(255, 100, 3), 200, CRGB(0xFFFFFF));
+  for (uint16_t i = 0; i < 10; i++)
+    CHECK_COLOR(s.out(i), expected);
+  CHECK_EQ(s.shows, 1);
+}
+
+TEST(many_mode_renders_each_led)
+{
+  Host_Strip s(300);
+  s.begin();
+  s.setColorCorrection(CRGB(255, 176, 240));
+  for (uint16_t i = 0; i < 300; i++)
+    s.setSingleColor(CRGB(i, 255 - (i & 0xFF), i * 7), i);
+  s.update();
+
+  for (uint16_t i = 0; i < 300; i++)
+    CHECK_COLOR(s.out(i), scaledColor(CRGB(i, 255 - (i & 0xFF), i * 7), 255, CRGB(255, 176, 240)));
+}
+
+TEST(unchanged_frames_are_not_shown)
+{
+  Host_Strip s(20);
+  s.begin();
+  s.setSingleColor(CRGB::Red, 3);
+  s.update();
+  CHECK_EQ(s.shows, 1);
+
+  hostAdvanceMillis(20);
+  s.update();
+  CHECK_EQ(s.shows, 1);
+
+  s.setSingleColor(CRGB::Blue, 4);
+  s.update();
+  CHECK_EQ(s.shows, 2);
+  CHECK_COLOR(s.out(4), scaledColor(CRGB::Blue, 255, CRGB(0xFFFFFF)));
+}
+
+TEST(brightness_transition_reaches_target)
+{
+  Host_Strip s(5);
+  s.begin(CRGB::White, 0);
+  s.setTransitionTime(500);
+  s.setBrightness(255).setPower(true);
+  s.update();
+
+  for (uint16_t t = 0; t <= 500; t += 20)
+  {
+    hostAdvanceMillis(20);
+    s.update();
+  }
+  CHECK_EQ(s.getBrightness(), 255);
+  CHECK(s.isSettled());
+  CHECK_COLOR(s.out(0), scaledColor(CRGB::White, 255, CRGB(0xFFFFFF)));
+}
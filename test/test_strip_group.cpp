@@ -0,0 +1,121 @@
+#include "test.h"
+
+#include <FASTLED_Strip.h>
+#include <LED_Strip_Group.h>
+
+/**
+ * FastLED strip that records which output buffer of the group was already rendered when it was shown
+*/
+class Group_Strip : public FASTLED_Strip<WS2812B, 2, GRB>
+{
+public:
+  const CRGB *watch = nullptr; // first output led of another strip in the group
+  CRGB watched;                // its value when this strip was shown
+
+  Group_Strip(const int p_nleds) : FASTLED_Strip(p_nleds) {}
+
+  void show() override
+  {
+    if (watch)
+      watched = *watch;
+    FASTLED_Strip::show();
+  }
+
+  inline CLEDController &controller()
+  {
+    return *chipset;
+  }
+
+  inline const CRGB *outputBuffer()
+  {
+    return m_leds;
+  }
+
+  Group_Strip &begin()
+  {
+    init(CRGB::Black, 255, 0);
+    setBrightness(255);
+    setPower(true);
+    return *this;
+  }
+};
+
+TEST(group_writes_changed_strips_once)
+{
+  Group_Strip a(60), b(120), c(300);
+  LED_Strip_Group<> group;
+  CHECK(group.add(a.begin()));
+  CHECK(group.add(b.begin()));
+  CHECK(group.add(c.begin()));
+
+  a.setColor(CRGB::Red);
+  b.setColor(CRGB::Green);
+  c.setColor(CRGB::Blue);
+  CHECK(group.update());
+  CHECK_EQ(group.getStats().shown, 3);
+  CHECK_EQ(group.getStats().modeled_time, CLEDController::modeledTime(60) + CLEDController::modeledTime(120) + CLEDController::modeledTime(300));
+  CHECK_EQ(a.controller().bytes_sent, 60 * 3);
+  CHECK_EQ(b.controller().bytes_sent, 120 * 3);
+  CHECK_EQ(c.controller().bytes_sent, 300 * 3);
+  CHECK_COLOR(c.controller().frame[299], scaledColor(CRGB::Blue, 255, CRGB(0xFFFFFF)));
+
+  // nothing changed -> no output phase at all
+  hostAdvanceMillis(20);
+  CHECK(!group.update());
+  CHECK_EQ(group.getStats().shown, 0);
+  CHECK_EQ(group.getStats().modeled_time, 0);
+
+  // only b changed -> only b is written
+  hostAdvanceMillis(20);
+  b.setSingleColor(CRGB::White, 7);
+  CHECK(group.update());
+  CHECK_EQ(group.getStats().shown, 1);
+  CHECK_EQ(group.getStats().modeled_time, CLEDController::modeledTime(120));
+  CHECK_EQ(a.controller().shows, 1);
+  CHECK_EQ(b.controller().shows, 2);
+  CHECK_EQ(c.controller().shows, 1);
+  CHECK_EQ(b.controller().bytes_sent, 2 * 120 * 3);
+}
+
+TEST(group_renders_all_strips_before_output)
+{
+  Group_Strip a(30), b(30);
+  LED_Strip_Group<> group;
+  group.add(a.begin());
+  group.add(b.begin());
+  a.watch = b.outputBuffer();
+
+  a.setColor(CRGB::Red);
+  b.setColor(CRGB::Blue);
+  group.update();
+
+  // b was already rendered when a was written
+  CHECK_COLOR(a.watched, scaledColor(CRGB::Blue, 255, CRGB(0xFFFFFF)));
+}
+
+TEST(group_output_phase_matches_modeled_time)
+{
+  Group_Strip a(100), b(200);
+  LED_Strip_Group<> group;
+  group.add(a.begin());
+  group.add(b.begin());
+
+  a.setColor(CRGB::Red);
+  b.setColor(CRGB::Blue);
+  group.update();
+
+  // the mock controller advances the host clock by the wire time, the output phase holds no other work
+  const LED_Strip_Group<>::Stats &stats = group.getStats();
+  CHECK_EQ(stats.output_time, stats.modeled_time);
+  CHECK_EQ(stats.output_time_max, stats.modeled_time);
+  CHECK_EQ(a.getOutputTime() + b.getOutputTime(), stats.modeled_time);
+}
+
+TEST(group_is_limited_to_max_strips)
+{
+  Group_Strip a(1), b(1), c(1);
+  LED_Strip_Group<2> group;
+  CHECK(group.add(a));
+  CHECK(group.add(b));
+  CHECK(!group.add(c));
+}
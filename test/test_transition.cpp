@@ -0,0 +1,165 @@
+#include "test.h"
+#include "host_strip.h"
+
+#include <LED_Transition.h>
+
+typedef LED_Transition<4> Transition;
+
+static const Transition::EASING EASINGS[] = {Transition::LINEAR, Transition::EASE_IN_OUT, Transition::EXPONENTIAL};
+
+// exposes the easing curves
+class Curve : public Transition
+{
+public:
+  using Transition::ease;
+};
+
+TEST(easing_curves_are_monotonic)
+{
+  for (Transition::EASING easing : EASINGS)
+  {
+    Curve c;
+    c.setEasing(easing);
+    uint32_t last = 0;
+    for (uint32_t p = 0; p < 65536; p++)
+    {
+      uint32_t e = c.ease(p);
+      if (!CHECK(e >= last && e <= 65536))
+      {
+        printf("easing %d at %u: %u after %u\n", easing, p, e, last);
+        break;
+      }
+      last = e;
+    }
+  }
+}
+
+/**
+ * run one transition twice in simulated time: updated every ms and woken only at the reported times
+ * @returns number of ms in which the sleeping transition showed a stale value
+*/
+static uint32_t staleMs(const Transition::EASING easing, const uint16_t duration, const uint8_t *from, const uint8_t *to, uint32_t *wakeups)
+{
+  Transition every, sleeping;
+  every.init(from, duration);
+  sleeping.init(from, duration);
+  every.setEasing(easing);
+  sleeping.setEasing(easing);
+  for (uint8_t i = 0; i < 4; i++)
+  {
+    every.setTarget(i, to[i]);
+    sleeping.setTarget(i, to[i]);
+  }
+
+  const uint32_t start = 1000;
+  uint32_t wake = start;
+  uint32_t stale = 0;
+  *wakeups = 0;
+  for (uint32_t now = start; now <= start + duration + 10; now++)
+  {
+    every.update(now);
+    if (now == wake)
+    {
+      sleeping.update(now);
+      (*wakeups)++;
+      uint32_t due = sleeping.timeUntilNextUpdate(now);
+      if (due == 0) // a due update right after updating would never let the caller sleep
+        return 0xFFFF;
+      wake = due == Transition::NEVER ? 0 : now + due;
+    }
+    for (uint8_t i = 0; i < 4; i++)
+    {
+      if (sleeping.getValue(i) != every.getValue(i))
+      {
+        stale++;
+        break;
+      }
+    }
+  }
+  if (!sleeping.settled() || wake != 0)
+    return 0xFFFF;
+  return stale;
+}
+
+TEST(sleeping_transition_never_shows_stale_values)
+{
+  static const uint8_t FROM[][4] = {{0, 0, 0, 0}, {255, 0, 128, 7}, {10, 200, 30, 40}, {100, 100, 100, 100}};
+  static const uint8_t TO[][4] = {{255, 3, 2, 0}, {0, 255, 129, 7}, {11, 199, 250, 0}, {100, 100, 100, 100}};
+  static const uint16_t DURATIONS[] = {1, 7, 255, 1200, 5000, 65535};
+  for (Transition::EASING easing : EASINGS)
+  {
+    for (uint16_t duration : DURATIONS)
+    {
+      for (uint8_t k = 0; k < 4; k++)
+      {
+        uint32_t wakeups;
+        uint32_t stale = staleMs(easing, duration, FROM[k], TO[k], &wakeups);
+        if (!CHECK_EQ(stale, 0))
+          printf("easing %d duration %u case %u\n", easing, duration, k);
+      }
+    }
+  }
+}
+
+TEST(sleeping_transition_wakes_only_for_changes)
+{
+  // 0 -> 255 in 1200 ms changes the value 255 times, one wakeup each plus the start
+  static const uint8_t FROM[4] = {0, 0, 0, 0};
+  static const uint8_t TO[4] = {255, 0, 0, 0};
+  for (Transition::EASING easing : EASINGS)
+  {
+    uint32_t wakeups;
+    CHECK_EQ(staleMs(easing, 1200, FROM, TO, &wakeups), 0);
+    CHECK(wakeups <= 256);
+    printf("easing %d: %u wakeups for 1200 ms\n", easing, wakeups);
+  }
+}
+
+TEST(random_transitions_never_show_stale_values)
+{
+  random16_set_seed(19);
+  for (uint16_t k = 0; k < 300; k++)
+  {
+    uint8_t from[4], to[4];
+    for (uint8_t i = 0; i < 4; i++)
+    {
+      from[i] = random8();
+      to[i] = random8();
+    }
+    uint16_t duration = 1 + random16() % 3000;
+    uint32_t wakeups;
+    if (!CHECK_EQ(staleMs(EASINGS[k % 3], duration, from, to, &wakeups), 0))
+      return;
+  }
+}
+
+TEST(strip_sleeping_until_next_update_matches_strip_updated_every_ms)
+{
+  for (Transition::EASING easing : EASINGS)
+  {
+    Host_Strip every(3), sleeping(3);
+    every.begin(CRGB(10, 20, 30), 20);
+    sleeping.begin(CRGB(10, 20, 30), 20);
+    every.setTransitionTime(1200).setTransitionEasing(easing);
+    sleeping.setTransitionTime(1200).setTransitionEasing(easing);
+    every.setColor(CRGB(250, 0, 90)).setBrightness(255);
+    sleeping.setColor(CRGB(250, 0, 90)).setBrightness(255);
+
+    uint32_t wake = millis();
+    uint32_t stale = 0;
+    for (uint16_t ms = 0; ms < 1300; ms++)
+    {
+      every.update();
+      if (millis() == wake)
+      {
+        sleeping.update();
+        uint32_t due = sleeping.nextUpdateDue();
+        wake = due == LED_Strip::NEVER ? 0 : millis() + max(due, 1u);
+      }
+      stale += sleeping.out(0) != every.out(0);
+      hostAdvanceMillis(1);
+    }
+    CHECK_EQ(stale, 0);
+    CHECK_EQ(wake, 0);
+  }
+}
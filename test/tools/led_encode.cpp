@@ -0,0 +1,211 @@
+#include "../host_strip.h"
+#include "../animation_clips.h"
+
+#include <LED_Animation.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * usage:
+ *   led_encode --out show.anim [--in frames.rgb | --clip comet|twinkle|rainbow] [--leds 300] [--fps 40] [--frames 0] [--keyframes 0] [--verify]
+ *     encodes raw rgb frames (leds * 3 bytes per frame, as exported by show tools) or a generated clip into an animation file
+ *     for LED_Animation_Player, --frames limits the number of frames (default whole file or 300 clip frames),
+ *     --keyframes forces a keyframe every n frames
+ *     --verify plays the written file through a memory mapping and compares every frame
+ * the result is printed as one JSON object
+*/
+
+struct Options
+{
+  const char *in = nullptr;
+  const char *out = nullptr;
+  CLIP clip = CLIP_COMET;
+  uint16_t leds = 300;
+  uint16_t fps = 40;
+  uint32_t frames = 0; // 0 -> whole input file or 300 frames of a clip
+  uint16_t keyframes = 0;
+  bool verify = false;
+};
+
+static bool parse(int argc, char **argv, Options &o)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const char *a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (strcmp(a, "--verify") == 0)
+      o.verify = true;
+    else if (!v)
+      return false;
+    else if (strcmp(a, "--in") == 0)
+      o.in = argv[++i];
+    else if (strcmp(a, "--out") == 0)
+      o.out = argv[++i];
+    else if (strcmp(a, "--leds") == 0)
+      o.leds = atoi(argv[++i]);
+    else if (strcmp(a, "--fps") == 0)
+      o.fps = atoi(argv[++i]);
+    else if (strcmp(a, "--frames") == 0)
+      o.frames = atol(argv[++i]);
+    else if (strcmp(a, "--keyframes") == 0)
+      o.keyframes = atoi(argv[++i]);
+    else if (strcmp(a, "--clip") == 0)
+    {
+      uint8_t c = 0;
+      while (c < CLIP_COUNT && strcmp(v, CLIP_NAMES[c]) != 0)
+        c++;
+      if (c == CLIP_COUNT)
+        return false;
+      o.clip = (CLIP)c;
+      i++;
+    }
+    else
+      return false;
+  }
+  return o.out && o.leds > 0 && o.fps > 0;
+}
+
+/**
+ * Print writing to a file
+*/
+class File_Print : public Print
+{
+protected:
+  FILE *m_file;
+
+public:
+  File_Print(FILE *file) : m_file(file) {}
+
+  size_t write(uint8_t c) override
+  {
+    return fputc(c, m_file) == EOF ? 0 : 1;
+  }
+
+  size_t write(const uint8_t *buffer, size_t size) override
+  {
+    return fwrite(buffer, 1, size, m_file);
+  }
+};
+
+/**
+ * frames from a raw rgb file or a generated clip
+*/
+class Frames
+{
+protected:
+  const Options &m_o;
+  FILE *m_file = nullptr;
+  std::vector<uint8_t> m_rgb;
+
+public:
+  Frames(const Options &o) : m_o(o), m_rgb(o.leds * 3) {}
+
+  ~Frames()
+  {
+    if (m_file)
+      fclose(m_file);
+  }
+
+  bool open()
+  {
+    if (m_file)
+      fclose(m_file);
+    m_file = nullptr;
+    return !m_o.in || (m_file = fopen(m_o.in, "rb"));
+  }
+
+  // frame f of the clip or the next frame of the file, false at the end
+  bool next(const uint32_t f, CRGB *leds)
+  {
+    if (m_o.frames && f >= m_o.frames)
+      return false;
+    if (!m_file)
+    {
+      clipFrame(m_o.clip, f, leds, m_o.leds);
+      return true;
+    }
+    if (fread(m_rgb.data(), 1, m_rgb.size(), m_file) != m_rgb.size())
+      return false;
+    for (uint16_t i = 0; i < m_o.leds; i++)
+      leds[i] = CRGB(m_rgb[i * 3], m_rgb[i * 3 + 1], m_rgb[i * 3 + 2]);
+    return true;
+  }
+};
+
+// play the written file and compare it with the input, @returns number of frames that match
+static uint32_t verify(const Options &o, Frames &frames)
+{
+  LED_Mapped_File mapped(o.out);
+  LED_Animation_Player<LED_Mapped_File> player(mapped);
+  player.setLoop(false);
+  if (!mapped.isOpen() || !player.begin() || !frames.open())
+    return 0;
+
+  Host_Strip strip(o.leds);
+  strip.begin();
+  std::vector<CRGB> expected(o.leds);
+  uint32_t f = 0;
+  for (; frames.next(f, expected.data()); f++)
+  {
+    if (!player.step(strip))
+      return f;
+    for (uint16_t i = 0; i < o.leds; i++)
+      if (strip.getRawColor(i) != expected[i])
+        return f;
+  }
+  return f;
+}
+
+int main(int argc, char **argv)
+{
+  Options o;
+  if (!parse(argc, argv, o))
+  {
+    fprintf(stderr, "usage: led_encode --out F [--in F | --clip comet|twinkle|rainbow] [--leds N] [--fps F] [--frames K] [--keyframes K] [--verify]\n");
+    return 2;
+  }
+  if (!o.in && !o.frames)
+    o.frames = 300;
+
+  Frames frames(o);
+  if (!frames.open())
+  {
+    fprintf(stderr, "cannot open %s\n", o.in);
+    return 1;
+  }
+  FILE *out = fopen(o.out, "wb");
+  if (!out)
+  {
+    fprintf(stderr, "cannot create %s\n", o.out);
+    return 1;
+  }
+
+  File_Print print(out);
+  size_t bytes;
+  uint32_t count = 0;
+  {
+    LED_Animation_Encoder enc(print, o.leds, o.fps, o.keyframes);
+    std::vector<CRGB> leds(o.leds);
+    while (frames.next(count, leds.data()))
+    {
+      enc.addFrame(leds.data());
+      count++;
+    }
+    bytes = enc.getBytes();
+  }
+  fclose(out);
+
+  uint64_t raw = (uint64_t)count * o.leds * 3;
+  printf("{\"frames\": %u, \"leds\": %u, \"fps\": %u, \"bytes\": %zu, \"raw_bytes\": %llu, \"ratio\": %.4f",
+         count, o.leds, o.fps, bytes, (unsigned long long)raw, raw ? (double)bytes / raw : 0.0);
+  int ret = count ? 0 : 1;
+  if (o.verify)
+  {
+    uint32_t ok = verify(o, frames);
+    printf(", \"verified\": %s", ok == count ? "true" : "false");
+    ret = ok == count ? ret : 1;
+  }
+  printf("}\n");
+  return ret;
+}
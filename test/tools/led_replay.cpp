@@ -0,0 +1,190 @@
+#include "../host_strip.h"
+#include "../host_udp.h"
+#include "../stream_packets.h"
+
+#include <LED_Stream_Receiver.h>
+
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+/**
+ * usage:
+ *   led_replay [--host 127.0.0.1] [--port 4048] [--e131] [--leds 300] [--fps 40] [--frames 0] [--file frames.rgb]
+ *     sends frames at a fixed rate, frames are read from a file of raw rgb data (leds * 3 bytes per frame, played in a loop)
+ *     or generated as a moving rainbow, --frames 0 sends until interrupted
+ *   led_replay --listen [--port 4048] [--leds 300] [--frames 0]
+ *     receives with LED_Stream_Receiver and prints the receiver stats once per second
+ * results are printed as one JSON object per line
+*/
+
+struct Options
+{
+  const char *host = "127.0.0.1";
+  uint16_t port = 0;
+  bool e131 = false;
+  bool listen = false;
+  uint16_t leds = 300;
+  double fps = 40;
+  uint32_t frames = 0;
+  const char *file = nullptr;
+};
+
+static bool parse(int argc, char **argv, Options &o)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    const char *a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (strcmp(a, "--e131") == 0)
+      o.e131 = true;
+    else if (strcmp(a, "--listen") == 0)
+      o.listen = true;
+    else if (!v)
+      return false;
+    else if (strcmp(a, "--host") == 0)
+      o.host = argv[++i];
+    else if (strcmp(a, "--port") == 0)
+      o.port = atoi(argv[++i]);
+    else if (strcmp(a, "--leds") == 0)
+      o.leds = atoi(argv[++i]);
+    else if (strcmp(a, "--fps") == 0)
+      o.fps = atof(argv[++i]);
+    else if (strcmp(a, "--frames") == 0)
+      o.frames = atol(argv[++i]);
+    else if (strcmp(a, "--file") == 0)
+      o.file = argv[++i];
+    else
+      return false;
+  }
+  if (o.port == 0)
+    o.port = o.e131 ? LED_Stream_Receiver::E131_PORT : LED_Stream_Receiver::DDP_PORT;
+  return o.leds > 0 && o.fps > 0;
+}
+
+// next frame from the file, rewinds at the end
+static bool readFrame(FILE *f, std::vector<uint8_t> &rgb)
+{
+  if (fread(rgb.data(), 1, rgb.size(), f) == rgb.size())
+    return true;
+  rewind(f);
+  return fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+}
+
+static void rainbow(std::vector<uint8_t> &rgb, const uint32_t frame)
+{
+  for (size_t i = 0; i < rgb.size() / 3; i++)
+  {
+    CRGB c;
+    hsv2rgb_rainbow(CHSV(i * 4 + frame * 2, 255, 255), c);
+    rgb[i * 3] = c.r;
+    rgb[i * 3 + 1] = c.g;
+    rgb[i * 3 + 2] = c.b;
+  }
+}
+
+static int replay(const Options &o)
+{
+  FILE *f = nullptr;
+  if (o.file && !(f = fopen(o.file, "rb")))
+  {
+    fprintf(stderr, "cannot open %s\n", o.file);
+    return 1;
+  }
+
+  Host_UDP udp;
+  std::vector<uint8_t> rgb(o.leds * 3);
+  const auto period = std::chrono::duration<double>(1.0 / o.fps);
+  const auto start = std::chrono::steady_clock::now();
+  auto next = start;
+  uint8_t seq = 0;
+  uint32_t frames = 0, packets = 0, errors = 0;
+  uint64_t bytes = 0;
+
+  for (; o.frames == 0 || frames < o.frames; frames++)
+  {
+    if (f)
+    {
+      if (!readFrame(f, rgb))
+      {
+        fprintf(stderr, "%s holds no frame of %u leds\n", o.file, o.leds);
+        return 1;
+      }
+    }
+    else
+      rainbow(rgb, frames);
+
+    for (const Packet &p : framePackets(o.e131, rgb.data(), o.leds, seq))
+    {
+      if (udp.send(o.host, o.port, p.data(), p.size()))
+      {
+        packets++;
+        bytes += p.size();
+      }
+      else
+        errors++;
+    }
+
+    next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+    std::this_thread::sleep_until(next);
+  }
+
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("{\"frames\": %u, \"packets\": %u, \"bytes\": %llu, \"errors\": %u, \"seconds\": %.3f, \"fps\": %.2f}\n",
+         frames, packets, (unsigned long long)bytes, errors, seconds, frames / seconds);
+  if (f)
+    fclose(f);
+  return errors ? 1 : 0;
+}
+
+static int listen(const Options &o)
+{
+  Host_UDP udp;
+  if (!udp.begin(o.port, "0.0.0.0"))
+  {
+    fprintf(stderr, "cannot bind port %u\n", o.port);
+    return 1;
+  }
+
+  Host_Strip strip(o.leds);
+  strip.begin();
+  LED_Stream_Receiver receiver(strip);
+  auto report = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  uint32_t frames = 0;
+
+  while (o.frames == 0 || frames < o.frames)
+  {
+    bool idle = true;
+    while (receiver.poll(udp))
+      idle = false;
+    if (receiver.available())
+    {
+      strip.update();
+      frames++;
+    }
+    if (idle)
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+
+    if (std::chrono::steady_clock::now() >= report || (o.frames && frames >= o.frames))
+    {
+      const LED_Stream_Receiver::Stats &st = receiver.getStats();
+      printf("{\"frames\": %u, \"packets\": %u, \"invalid\": %u, \"dropped\": %u, \"late\": %u}\n",
+             st.frames, st.packets, st.invalid, st.dropped, st.late);
+      fflush(stdout);
+      report += std::chrono::seconds(1);
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char **argv)
+{
+  Options o;
+  if (!parse(argc, argv, o))
+  {
+    fprintf(stderr, "usage: led_replay [--listen] [--host H] [--port P] [--e131] [--leds N] [--fps F] [--frames K] [--file F]\n");
+    return 2;
+  }
+  return o.listen ? listen(o) : replay(o);
+}